@@ -0,0 +1,298 @@
+#include "AddressExpr.hpp"
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+
+int AddressExprPool::compile(const std::string& text) {
+    if (external != nullptr) {
+        throw std::runtime_error("Cannot compile into an attached expression pool");
+    }
+    
+    int exprId = static_cast<int>(code.size());
+    ParseState st{text, 0, 0, 0};
+
+    try {
+        parseSum(st);
+        skipSpaces(st);
+        if (st.pos != text.size()) {
+            throw std::runtime_error("unexpected '" + std::string(1, text[st.pos]) + "'");
+        }
+    } catch (const std::exception& e) {
+        code.resize(exprId);  // Drop partially emitted code
+        throw std::runtime_error("Invalid address expression \"" + text + "\": " + e.what());
+    }
+
+    code.push_back({ExprOpcode::End, 0, 0});
+    return exprId;
+}
+
+// Add, Sub, Mul and Neg wrap modulo 2^64 like the uint64_t address they
+// produce; signed overflow would be undefined
+static int64_t wrap(uint64_t value) {
+    return static_cast<int64_t>(value);
+}
+
+uint64_t AddressExprPool::evaluate(int exprId, const int64_t* vars) const {
+    int64_t stack[kMaxStackDepth];
+    int top = 0;
+
+    for (const ExprInstr* in = data() + exprId; ; ++in) {
+        switch (in->op) {
+            case ExprOpcode::Push:
+                stack[top++] = in->value;
+                break;
+            case ExprOpcode::Load:
+                stack[top++] = vars[in->slot];
+                break;
+            case ExprOpcode::Add:
+                --top;
+                stack[top - 1] = wrap(static_cast<uint64_t>(stack[top - 1]) + static_cast<uint64_t>(stack[top]));
+                break;
+            case ExprOpcode::Sub:
+                --top;
+                stack[top - 1] = wrap(static_cast<uint64_t>(stack[top - 1]) - static_cast<uint64_t>(stack[top]));
+                break;
+            case ExprOpcode::Mul:
+                --top;
+                stack[top - 1] = wrap(static_cast<uint64_t>(stack[top - 1]) * static_cast<uint64_t>(stack[top]));
+                break;
+            case ExprOpcode::Div:
+                --top;
+                if (stack[top] == 0) {
+                    throw std::runtime_error("Division by zero in address expression");
+                }
+                if (stack[top] == -1 && stack[top - 1] == std::numeric_limits<int64_t>::min()) {
+                    throw std::runtime_error("Integer overflow in address expression");
+                }
+                stack[top - 1] /= stack[top];
+                break;
+            case ExprOpcode::Mod:
+                --top;
+                if (stack[top] == 0) {
+                    throw std::runtime_error("Division by zero in address expression");
+                }
+                // x % -1 is always 0; computing it traps for the most negative x
+                stack[top - 1] = stack[top] == -1 ? 0 : stack[top - 1] % stack[top];
+                break;
+            case ExprOpcode::Neg:
+                stack[top - 1] = wrap(0 - static_cast<uint64_t>(stack[top - 1]));
+                break;
+            case ExprOpcode::End:
+                return static_cast<uint64_t>(stack[0]);
+        }
+    }
+}
+
+int AddressExprPool::highestVariable(int exprId) const {
+    int highest = -1;
+    for (const ExprInstr* in = data() + exprId; in->op != ExprOpcode::End; ++in) {
+        if (in->op == ExprOpcode::Load && in->slot > highest) {
+            highest = in->slot;
+        }
+    }
+    return highest;
+}
+
+bool AddressExprPool::usesVariable(int exprId, int slot) const {
+    for (const ExprInstr* in = data() + exprId; in->op != ExprOpcode::End; ++in) {
+        if (in->op == ExprOpcode::Load && in->slot == slot) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int AddressExprPool::append(const AddressExprPool& other) {
+    if (external != nullptr) {
+        throw std::runtime_error("Cannot compile into an attached expression pool");
+    }
+    
+    // Expression ids are code offsets and the code has no internal jumps
+    int offset = static_cast<int>(code.size());
+    code.insert(code.end(), other.data(), other.data() + other.size());
+    return offset;
+}
+
+void AddressExprPool::attach(const ExprInstr* instrs, size_t count) {
+    code.clear();
+    external = instrs;
+    externalSize = count;
+}
+
+void AddressExprPool::verify(const ExprInstr* instrs, size_t count, std::vector<bool>& starts) {
+    starts.assign(count, false);
+    int depth = 0;
+
+    for (size_t idx = 0; idx < count; idx++) {
+        const ExprInstr& in = instrs[idx];
+        if (depth == 0) {
+            starts[idx] = true;
+        }
+        auto where = [&] { return " at expression instruction " + std::to_string(idx); };
+
+        // Stack effect of each opcode, checked as evaluate() would apply it
+        int pops = 0;
+        int pushes = 0;
+        switch (in.op) {
+            case ExprOpcode::Push:
+                pushes = 1;
+                break;
+            case ExprOpcode::Load:
+                if (in.slot < 0 || in.slot >= kNumVariables) {
+                    throw std::runtime_error("Unknown variable slot " + std::to_string(in.slot) + where());
+                }
+                pushes = 1;
+                break;
+            case ExprOpcode::Add:
+            case ExprOpcode::Sub:
+            case ExprOpcode::Mul:
+            case ExprOpcode::Div:
+            case ExprOpcode::Mod:
+                pops = 2;
+                pushes = 1;
+                break;
+            case ExprOpcode::Neg:
+                pops = 1;
+                pushes = 1;
+                break;
+            case ExprOpcode::End:
+                if (depth != 1) {
+                    throw std::runtime_error("Expression leaves " + std::to_string(depth) +
+                                             " values" + where());
+                }
+                depth = 0;
+                continue;
+            default:
+                throw std::runtime_error("Unknown opcode " + std::to_string(static_cast<int32_t>(in.op)) + where());
+        }
+
+        if (depth < pops) {
+            throw std::runtime_error("Stack underflow" + where());
+        }
+        depth += pushes - pops;
+        if (depth > kMaxStackDepth) {
+            throw std::runtime_error("Stack deeper than " + std::to_string(kMaxStackDepth) + where());
+        }
+    }
+
+    if (depth != 0) {
+        throw std::runtime_error("Unterminated expression code");
+    }
+}
+
+void AddressExprPool::emit(ParseState& st, ExprInstr instr, int stackDelta) {
+    st.depth += stackDelta;
+    if (st.depth > kMaxStackDepth) {
+        throw std::runtime_error("expression nested too deeply");
+    }
+    code.push_back(instr);
+}
+
+void AddressExprPool::skipSpaces(ParseState& st) {
+    while (st.pos < st.text.size() && std::isspace(static_cast<unsigned char>(st.text[st.pos]))) {
+        st.pos++;
+    }
+}
+
+void AddressExprPool::parseSum(ParseState& st) {
+    parseProduct(st);
+    for (;;) {
+        skipSpaces(st);
+        if (st.pos >= st.text.size()) {
+            return;
+        }
+        char c = st.text[st.pos];
+        if (c != '+' && c != '-') {
+            return;
+        }
+        st.pos++;
+        parseProduct(st);
+        emit(st, {c == '+' ? ExprOpcode::Add : ExprOpcode::Sub, 0, 0}, -1);
+    }
+}
+
+void AddressExprPool::parseProduct(ParseState& st) {
+    parseFactor(st);
+    for (;;) {
+        skipSpaces(st);
+        if (st.pos >= st.text.size()) {
+            return;
+        }
+        char c = st.text[st.pos];
+        ExprOpcode op;
+        if (c == '*') {
+            op = ExprOpcode::Mul;
+        } else if (c == '/') {
+            op = ExprOpcode::Div;
+        } else if (c == '%') {
+            op = ExprOpcode::Mod;
+        } else {
+            return;
+        }
+        st.pos++;
+        parseFactor(st);
+        emit(st, {op, 0, 0}, -1);
+    }
+}
+
+void AddressExprPool::parseFactor(ParseState& st) {
+    skipSpaces(st);
+    if (st.pos >= st.text.size()) {
+        throw std::runtime_error("unexpected end of expression");
+    }
+
+    const std::string& s = st.text;
+    char c = s[st.pos];
+
+    // Parentheses and unary minus recurse without growing the evaluation stack
+    if ((c == '(' || c == '-') && ++st.nesting > kMaxNesting) {
+        throw std::runtime_error("expression nested too deeply");
+    }
+
+    if (c == '(') {
+        st.pos++;
+        parseSum(st);
+        skipSpaces(st);
+        if (st.pos >= s.size() || s[st.pos] != ')') {
+            throw std::runtime_error("missing ')'");
+        }
+        st.pos++;
+        st.nesting--;
+    } else if (c == '-') {
+        st.pos++;
+        parseFactor(st);
+        emit(st, {ExprOpcode::Neg, 0, 0}, 0);
+        st.nesting--;
+    } else if (std::isdigit(static_cast<unsigned char>(c))) {
+        int base = 10;
+        if (c == '0' && st.pos + 1 < s.size() && (s[st.pos + 1] == 'x' || s[st.pos + 1] == 'X')) {
+            base = 16;
+            st.pos += 2;
+        }
+        size_t start = st.pos;
+        while (st.pos < s.size() && std::isxdigit(static_cast<unsigned char>(s[st.pos])) &&
+               (base == 16 || std::isdigit(static_cast<unsigned char>(s[st.pos])))) {
+            st.pos++;
+        }
+        if (st.pos == start) {
+            throw std::runtime_error("malformed number");
+        }
+        int64_t value = static_cast<int64_t>(std::stoull(s.substr(start, st.pos - start), nullptr, base));
+        emit(st, {ExprOpcode::Push, 0, value}, 1);
+    } else {
+        // Variables are single letters: i, then j..m for loop levels 0..3
+        static const char kVariableNames[kNumVariables + 1] = "ijklm";
+        int slot = -1;
+        for (int v = 0; v < kNumVariables; v++) {
+            if (c == kVariableNames[v]) {
+                slot = v;
+            }
+        }
+        bool isWord = st.pos + 1 < s.size() && std::isalnum(static_cast<unsigned char>(s[st.pos + 1]));
+        if (slot < 0 || isWord) {
+            throw std::runtime_error("unknown variable at position " + std::to_string(st.pos));
+        }
+        st.pos++;
+        emit(st, {ExprOpcode::Load, slot, 0}, 1);
+    }
+}
@@ -0,0 +1,124 @@
+#ifndef ADDRESSEXPR_HPP
+#define ADDRESSEXPR_HPP
+
+#include "Types.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Postfix opcodes of a compiled address expression
+enum class ExprOpcode : int32_t {
+    Push,
+    Load,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    Neg,
+    End
+};
+
+// One postfix instruction; expressions are runs of these ending in End
+struct ExprInstr {
+    ExprOpcode op;
+    int32_t slot;   // Variable slot for Load
+    int64_t value;  // Constant for Push
+};
+
+/**
+ * AddressExprPool class
+ * Compiles integer address expressions from ops.csv into postfix code and
+ * evaluates them per executed memory op.
+ *
+ * Variables: i = execution index of the task instance, j/k/l/m = counters of
+ * the enclosing repeat blocks from outermost to innermost.
+ * Operators: + - * / % and parentheses. Numbers with a 0x prefix are hex,
+ * all others decimal.
+ */
+class AddressExprPool {
+public:
+    // Number of variable slots passed to evaluate(): i plus one per loop level
+    static constexpr int kNumVariables = 1 + kMaxLoopDepth;
+
+    /**
+     * Compile an expression and append it to the pool
+     * @param text Expression source, e.g. "0x10000000 + i*0x1000 + j*64"
+     * @return Expression id for evaluate()
+     */
+    int compile(const std::string& text);
+
+    /**
+     * Evaluate a compiled expression
+     * @param exprId Id returned by compile()
+     * @param vars Variable values indexed by slot (i, j, k, l, m)
+     * @return Resulting address
+     */
+    uint64_t evaluate(int exprId, const int64_t* vars) const;
+
+    /**
+     * Get the highest variable slot an expression references
+     * @param exprId Id returned by compile()
+     * @return Slot index (0 = i, 1 = j, ...), or -1 for a constant expression
+     */
+    int highestVariable(int exprId) const;
+
+    /**
+     * Check whether an expression reads a variable
+     * @param exprId Id returned by compile()
+     * @param slot Variable slot (0 = i, 1 = j, ...)
+     * @return True if the expression loads the slot
+     */
+    bool usesVariable(int exprId, int slot) const;
+
+    /**
+     * Append all expressions of another pool
+     * @param other Pool compiled separately (e.g. by a parser thread)
+     * @return Offset to add to the other pool's expression ids
+     */
+    int append(const AddressExprPool& other);
+
+    /**
+     * Use externally owned code (e.g. a mapped graph file) instead of compiling
+     * @param instrs Instruction array that outlives the pool
+     * @param count Number of instructions
+     */
+    void attach(const ExprInstr* instrs, size_t count);
+
+    /**
+     * Check externally produced code before attaching it
+     * @param instrs Instruction array
+     * @param count Number of instructions
+     * @param starts Set to true at every index where an expression begins
+     * @throws std::runtime_error on an unknown opcode or variable, a stack
+     *         underflow or overflow, or code not ending in End
+     */
+    static void verify(const ExprInstr* instrs, size_t count, std::vector<bool>& starts);
+
+    const ExprInstr* data() const { return external != nullptr ? external : code.data(); }
+    size_t size() const { return external != nullptr ? externalSize : code.size(); }
+
+private:
+    static constexpr int kMaxStackDepth = 16;
+    static constexpr int kMaxNesting = 64;  // Parenthesis and unary minus levels
+
+    std::vector<ExprInstr> code;  // All expressions, each terminated by End
+    const ExprInstr* external = nullptr;
+    size_t externalSize = 0;
+
+    // Recursive-descent helpers; depth tracks the evaluation stack height,
+    // nesting the parser's own recursion
+    struct ParseState {
+        const std::string& text;
+        size_t pos;
+        int depth;
+        int nesting;
+    };
+    void parseSum(ParseState& st);
+    void parseProduct(ParseState& st);
+    void parseFactor(ParseState& st);
+    void emit(ParseState& st, ExprInstr instr, int stackDelta);
+    static void skipSpaces(ParseState& st);
+};
+
+#endif // ADDRESSEXPR_HPP
@@ -1,13 +1,221 @@
 #ifndef CSVPARSER_HPP
 #define CSVPARSER_HPP
 
+#include "CSVScan.hpp"
+#include <charconv>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 
+/**
+ * CSVReader class
+ * Zero-copy reader over an in-memory CSV buffer (typically a MappedFile).
+ * Header columns are resolved to indices once; each row is split into
+ * string_views into the buffer, reusing one field array, so the row loop
+ * does not allocate. Quoted fields are returned without their quotes.
+ */
+class CSVReader {
+public:
+    /**
+     * Read the header row of a CSV buffer
+     * @param data Buffer holding the whole file; must outlive the reader
+     * @param size Buffer size in bytes
+     * @param source File name used in error messages
+     */
+    CSVReader(const char* data, size_t size, const std::string& source)
+        : cursor(data), limit(data + size), sourceName(source), line(0) {
+        if (!next()) {
+            throw std::runtime_error("CSV file is empty: " + sourceName);
+        }
+        headers.assign(fields.begin(), fields.end());
+        if (headers.size() == 1 && headers[0].empty()) {
+            throw std::runtime_error("CSV file has empty header row: " + sourceName);
+        }
+    }
+    
+    /**
+     * Read data rows from a slice of the buffer another reader took its header from
+     * @param header Reader positioned after the header row
+     * @param begin First byte of the slice (start of a line)
+     * @param end One past the last byte of the slice (end of a line)
+     * @param firstLine 1-based line number of the slice's first line
+     */
+    CSVReader(const CSVReader& header, const char* begin, const char* end, size_t firstLine)
+        : cursor(begin), limit(end), sourceName(header.sourceName), line(firstLine - 1),
+          headers(header.headers) {
+    }
+    
+    // Index of a header column, or -1 if the file has no such column
+    int column(std::string_view name) const {
+        for (size_t i = 0; i < headers.size(); i++) {
+            if (headers[i] == name) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+    
+    // Index of a header column that must be present
+    int requireColumn(std::string_view name) const {
+        int idx = column(name);
+        if (idx < 0) {
+            throw std::runtime_error("CSV file " + sourceName + " has no '" + std::string(name) + "' column");
+        }
+        return idx;
+    }
+    
+    /**
+     * Advance to the next non-blank row
+     * @return False at end of input
+     */
+    bool next() {
+        while (cursor < limit) {
+            const char* begin = cursor;
+            const char* end = CSVScan::scanRow(begin, limit, separators);
+            cursor = end < limit ? end + 1 : limit;
+            line++;
+            
+            if (isBlank(begin, end)) {
+                continue;
+            }
+            splitFields(begin, end);
+            
+            if (!headers.empty() && fields.size() != headers.size()) {
+                throw std::runtime_error(
+                    "CSV line " + std::to_string(line) +
+                    " has " + std::to_string(fields.size()) +
+                    " fields but header has " + std::to_string(headers.size()) +
+                    " fields in file: " + sourceName
+                );
+            }
+            return true;
+        }
+        return false;
+    }
+    
+    // Position of the next unread row and end of the buffer
+    const char* position() const { return cursor; }
+    const char* end() const { return limit; }
+    
+    // Number of lines in [begin, end), counting a final line without a newline
+    static size_t countLines(const char* begin, const char* end) {
+        size_t count = 0;
+        while (begin < end) {
+            const char* nl = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+            count++;
+            if (nl == nullptr) {
+                break;
+            }
+            begin = nl + 1;
+        }
+        return count;
+    }
+    
+    // Field of the current row
+    std::string_view field(int col) const { return fields[col]; }
+    
+    // 1-based line number of the current row
+    size_t lineNumber() const { return line; }
+    
+    // Decimal integer field; empty or malformed values are errors
+    template <typename Int>
+    Int parseInt(int col) const {
+        std::string_view text = fields[col];
+        Int value = 0;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size()) {
+            throw std::runtime_error(fieldError(col, "integer"));
+        }
+        return value;
+    }
+    
+    // Hexadecimal field, with or without a 0x prefix
+    uint64_t parseHex(int col) const {
+        uint64_t value = 0;
+        if (!parseHexText(fields[col], value)) {
+            throw std::runtime_error(fieldError(col, "hex number"));
+        }
+        return value;
+    }
+    
+    // Parse hex text with an optional 0x prefix; false if malformed
+    static bool parseHexText(std::string_view text, uint64_t& value) {
+        return CSVScan::parseHex(text, value);
+    }
+    
+    // Error message naming the file, line and column of a bad field
+    std::string fieldError(int col, const std::string& expected) const {
+        return "Invalid " + expected + " '" + std::string(fields[col]) + "' in column '" +
+               std::string(headers[col]) + "' at line " + std::to_string(line) + " of " + sourceName;
+    }
+    
+private:
+    const char* cursor;
+    const char* limit;
+    std::string sourceName;
+    size_t line;
+    std::vector<std::string_view> headers;
+    std::vector<std::string_view> fields;   // Reused for every row
+    std::vector<uint32_t> separators;       // Offsets of ',' and '"' in the current row
+    
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+    
+    static bool isBlank(const char* begin, const char* end) {
+        for (; begin < end; begin++) {
+            if (!isSpace(*begin)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // Trim whitespace, then strip one pair of enclosing quotes
+    static std::string_view makeField(const char* begin, const char* end) {
+        while (begin < end && isSpace(*begin)) {
+            begin++;
+        }
+        while (end > begin && isSpace(end[-1])) {
+            end--;
+        }
+        if (end - begin >= 2 && *begin == '"' && end[-1] == '"') {
+            begin++;
+            end--;
+        }
+        return std::string_view(begin, end - begin);
+    }
+    
+    // Split the current row at the separators found by CSVScan::scanRow
+    void splitFields(const char* begin, const char* end) {
+        fields.clear();
+        const char* start = begin;
+        bool inQuotes = false;
+        for (uint32_t offset : separators) {
+            const char* p = begin + offset;
+            if (*p == '"') {
+                inQuotes = !inQuotes;
+            } else if (!inQuotes) {
+                fields.push_back(makeField(start, p));
+                start = p + 1;
+            }
+        }
+        fields.push_back(makeField(start, end));
+    }
+};
+
+/**
+ * CSVParser class
+ * Convenience parser returning every row as a column-name map. Simple but
+ * allocation heavy; bulk inputs go through CSVReader.
+ */
 class CSVParser {
 public:
     // Parse CSV file and return rows as vector of maps (column_name -> value)
@@ -0,0 +1,192 @@
+#include "CSVScan.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CSVSCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// Scan [p, end) one byte at a time; offsets are relative to begin
+static const char* scanRowTail(const char* begin, const char* p, const char* end,
+                               std::vector<uint32_t>& separators) {
+    for (; p < end; p++) {
+        char c = *p;
+        if (c == '\n') {
+            return p;
+        }
+        if (c == ',' || c == '"') {
+            separators.push_back(static_cast<uint32_t>(p - begin));
+        }
+    }
+    return end;
+}
+
+static const char* scanRowScalar(const char* begin, const char* end, std::vector<uint32_t>& separators) {
+    return scanRowTail(begin, begin, end, separators);
+}
+
+// Hex digits without prefix; false if empty, malformed or over 64 bits
+static bool parseHexDigits(std::string_view text, uint64_t& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+    return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+static std::string_view stripHexPrefix(std::string_view text) {
+    if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text.remove_prefix(2);
+    }
+    return text;
+}
+
+static bool parseHexScalar(std::string_view text, uint64_t& value) {
+    return parseHexDigits(stripHexPrefix(text), value);
+}
+
+#ifdef CSVSCAN_X86
+
+// Append base + position of every set bit of mask
+static inline void appendBits(std::vector<uint32_t>& separators, uint32_t mask, size_t base) {
+    while (mask != 0) {
+        separators.push_back(static_cast<uint32_t>(base + __builtin_ctz(mask)));
+        mask &= mask - 1;
+    }
+}
+
+__attribute__((target("sse4.2")))
+static const char* scanRowSSE42(const char* begin, const char* end, std::vector<uint32_t>& separators) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    const char* p = begin;
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t sepMask = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, quote))));
+        uint32_t lineMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        if (lineMask != 0) {
+            // Keep only separators before the first newline
+            appendBits(separators, sepMask & ((lineMask & -lineMask) - 1), p - begin);
+            return p + __builtin_ctz(lineMask);
+        }
+        appendBits(separators, sepMask, p - begin);
+        p += 16;
+    }
+    return scanRowTail(begin, p, end, separators);
+}
+
+__attribute__((target("avx2")))
+static const char* scanRowAVX2(const char* begin, const char* end, std::vector<uint32_t>& separators) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    const char* p = begin;
+    while (end - p >= 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        uint32_t sepMask = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, comma), _mm256_cmpeq_epi8(block, quote))));
+        uint32_t lineMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+        if (lineMask != 0) {
+            appendBits(separators, sepMask & ((lineMask & -lineMask) - 1), p - begin);
+            return p + __builtin_ctz(lineMask);
+        }
+        appendBits(separators, sepMask, p - begin);
+        p += 32;
+    }
+    return scanRowTail(begin, p, end, separators);
+}
+
+// Decode up to 16 hex digits at once: classify and convert all bytes, then
+// merge nibble pairs into bytes and byte-swap the big-endian result
+__attribute__((target("sse4.2")))
+static bool parseHexSSE42(std::string_view text, uint64_t& value) {
+    text = stripHexPrefix(text);
+    size_t length = text.size();
+    if (length == 0 || length > 16) {
+        return parseHexDigits(text, value);
+    }
+
+    // Right-align the digits behind '0' padding. The 16-byte load may read
+    // past the field but never into the next page, so it cannot fault.
+    __m128i raw;
+    uintptr_t pageOffset = reinterpret_cast<uintptr_t>(text.data()) & 4095;
+    if (pageOffset <= 4096 - 16) {
+        raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data()));
+    } else {
+        char buffer[16] = {};
+        std::memcpy(buffer, text.data(), length);
+        raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
+    }
+    const __m128i lane = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i pad = _mm_set1_epi8(static_cast<char>(16 - length));
+    __m128i shifted = _mm_shuffle_epi8(raw, _mm_sub_epi8(lane, pad));  // Negative index -> 0
+    __m128i chars = _mm_blendv_epi8(shifted, _mm_set1_epi8('0'), _mm_cmpgt_epi8(pad, lane));
+
+    // Unsigned range checks: c - '0' <= 9 or (c | 0x20) - 'a' <= 5
+    __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF) {
+        return false;
+    }
+
+    __m128i nibbles = _mm_blendv_epi8(_mm_add_epi8(letter, _mm_set1_epi8(10)), digit, isDigit);
+    __m128i bytes = _mm_maddubs_epi16(nibbles, _mm_set1_epi16(0x0110));  // hi * 16 + lo
+    __m128i packed = _mm_packus_epi16(bytes, bytes);
+    value = __builtin_bswap64(static_cast<uint64_t>(_mm_cvtsi128_si64(packed)));
+    return true;
+}
+
+#endif // CSVSCAN_X86
+
+// Constant-initialized so scanning works even before dynamic initialization
+CSVScan::ScanRowFn CSVScan::scanRowImpl = scanRowScalar;
+CSVScan::ParseHexFn CSVScan::parseHexImpl = parseHexScalar;
+SimdLevel CSVScan::level = SimdLevel::Scalar;
+
+// Install the best kernels at startup
+[[maybe_unused]] static const bool kKernelsSelected = (CSVScan::setLevel(CSVScan::detectLevel()), true);
+
+SimdLevel CSVScan::detectLevel() {
+#ifdef CSVSCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return SimdLevel::SSE42;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+void CSVScan::setLevel(SimdLevel requested) {
+    level = std::min(requested, detectLevel());
+    scanRowImpl = scanRowScalar;
+    parseHexImpl = parseHexScalar;
+#ifdef CSVSCAN_X86
+    if (level == SimdLevel::AVX2) {
+        scanRowImpl = scanRowAVX2;
+        parseHexImpl = parseHexSSE42;
+    } else if (level == SimdLevel::SSE42) {
+        scanRowImpl = scanRowSSE42;
+        parseHexImpl = parseHexSSE42;
+    }
+#endif
+}
+
+const char* CSVScan::levelName(SimdLevel simdLevel) {
+    switch (simdLevel) {
+        case SimdLevel::AVX2:
+            return "AVX2";
+        case SimdLevel::SSE42:
+            return "SSE4.2";
+        case SimdLevel::Scalar:
+            break;
+    }
+    return "scalar";
+}
@@ -0,0 +1,66 @@
+#ifndef CSVSCAN_HPP
+#define CSVSCAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Instruction set used by the CSV scanning kernels
+enum class SimdLevel {
+    Scalar,
+    SSE42,   // 16-byte blocks
+    AVX2     // 32-byte blocks
+};
+
+/**
+ * CSVScan class
+ * Vectorized kernels behind CSVReader. The widest kernel the CPU supports is
+ * chosen once at startup; non-x86 builds always use the scalar kernels.
+ */
+class CSVScan {
+public:
+    /**
+     * Find the end of the row starting at begin and collect its separators
+     * @param begin First byte of the row
+     * @param end End of the buffer (never read past)
+     * @param separators Cleared, then filled with offsets of ',' and '"' from begin
+     * @return Position of the row's '\n', or end if the row is the last one
+     */
+    static const char* scanRow(const char* begin, const char* end, std::vector<uint32_t>& separators) {
+        separators.clear();
+        return scanRowImpl(begin, end, separators);
+    }
+
+    /**
+     * Parse hex text with an optional 0x prefix
+     * @param text Digits; up to 16 significant digits take the vector path
+     * @param value Parsed value
+     * @return False if the text is empty, malformed or overflows 64 bits
+     */
+    static bool parseHex(std::string_view text, uint64_t& value) {
+        return parseHexImpl(text, value);
+    }
+
+    // Best level supported by this CPU
+    static SimdLevel detectLevel();
+
+    // Level of the installed kernels
+    static SimdLevel activeLevel() { return level; }
+
+    // Install the kernels of a level, capped at detectLevel(); not thread safe,
+    // meant for benchmarks and tests
+    static void setLevel(SimdLevel requested);
+
+    static const char* levelName(SimdLevel simdLevel);
+
+private:
+    using ScanRowFn = const char* (*)(const char*, const char*, std::vector<uint32_t>&);
+    using ParseHexFn = bool (*)(std::string_view, uint64_t&);
+
+    static ScanRowFn scanRowImpl;
+    static ParseHexFn parseHexImpl;
+    static SimdLevel level;
+};
+
+#endif // CSVSCAN_HPP
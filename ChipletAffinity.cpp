@@ -0,0 +1,141 @@
+#include "ChipletAffinity.hpp"
+#include "MemoryBank.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+ChipletAffinity::ChipletAffinity(const Config& config, const TaskGraph& graph)
+    : config(config), graph(graph), scratch(config.numChiplets, 0) {
+    const std::vector<Task>& tasks = graph.getTasks();
+    taskHome.assign(tasks.size(), -1);
+
+    // Op programs: one walk per task, tasks split across workers
+    parallelFor(tasks.size(), 64, [&](size_t begin, size_t end) {
+        std::vector<uint64_t> local(config.numChiplets);
+        for (size_t t = begin; t < end; t++) {
+            if (tasks[t].trace >= 0) {
+                continue;
+            }
+            OpSpan ops(graph.opData() + tasks[t].opBegin, tasks[t].opCount);
+            if (usesExecutionIndex(ops)) {
+                taskHome[t] = kPerInstance;
+                continue;
+            }
+            std::fill(local.begin(), local.end(), 0);
+            countAccesses(ops, 0, local);
+            taskHome[t] = busiest(local);
+        }
+    });
+
+    // Traces are scanned once each (tasks may share one)
+    std::map<const TraceFile*, int> traceHomes;
+    for (size_t t = 0; t < tasks.size(); t++) {
+        const TraceFile* trace = graph.getTrace(tasks[t].id);
+        if (trace != nullptr) {
+            auto it = traceHomes.find(trace);
+            if (it == traceHomes.end()) {
+                std::vector<uint64_t> traceCounts(config.numChiplets);
+                countAccesses(*trace, traceCounts);
+                it = traceHomes.emplace(trace, busiest(traceCounts)).first;
+            }
+            taskHome[t] = it->second;
+        }
+    }
+}
+
+int ChipletAffinity::homeChiplet(int taskIndex, int32_t executionIndex) const {
+    if (taskIndex < 0 || static_cast<size_t>(taskIndex) >= taskHome.size()) {
+        return -1;
+    }
+    if (taskHome[taskIndex] != kPerInstance) {
+        return taskHome[taskIndex];
+    }
+
+    const Task& task = graph.getTasks()[taskIndex];
+    std::fill(scratch.begin(), scratch.end(), 0);
+    countAccesses(OpSpan(graph.opData() + task.opBegin, task.opCount), executionIndex, scratch);
+    return busiest(scratch);
+}
+
+void ChipletAffinity::countAccesses(OpSpan ops, int32_t executionIndex, std::vector<uint64_t>& counts) const {
+    int64_t vars[AddressExprPool::kNumVariables] = {};
+    vars[0] = executionIndex;
+    int loopDepth = 0;
+
+    // Same loop semantics as Core::skipControlOps
+    for (size_t opIndex = 0; opIndex < ops.size(); opIndex++) {
+        const Op& op = ops[opIndex];
+        if (op.type == OpType::Memory) {
+            int chiplet = bankChiplet(graph.resolveAddress(op, vars));
+            if (chiplet >= 0) {
+                counts[chiplet]++;
+            }
+        } else if (op.type == OpType::Repeat) {
+            vars[1 + loopDepth] = 0;
+            loopDepth++;
+        } else if (op.type == OpType::EndRepeat) {
+            // EndRepeat::cycles holds the index of the matching Repeat
+            if (++vars[loopDepth] < ops[op.cycles].cycles) {
+                opIndex = static_cast<size_t>(op.cycles);
+            } else {
+                loopDepth--;
+            }
+        }
+    }
+}
+
+void ChipletAffinity::countAccesses(const TraceFile& trace, std::vector<uint64_t>& counts) const {
+    std::mutex merge;
+    const TraceRecord* records = trace.records();
+
+    parallelFor(trace.size(), 1 << 20, [&](size_t begin, size_t end) {
+        std::vector<uint64_t> local(counts.size());
+        for (size_t r = begin; r < end; r++) {
+            // The first line keeps the record's address, as Core issues it
+            const TraceRecord& record = records[r];
+            uint64_t lines = TraceFile::lineCount(record);
+            uint64_t lineBase = record.address / kTraceLineBytes * kTraceLineBytes;
+            for (uint64_t l = 0; l < lines; l++) {
+                int chiplet = bankChiplet(l == 0 ? record.address : lineBase + l * kTraceLineBytes);
+                if (chiplet >= 0) {
+                    local[chiplet]++;
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(merge);
+        for (size_t c = 0; c < counts.size(); c++) {
+            counts[c] += local[c];
+        }
+    });
+}
+
+int ChipletAffinity::bankChiplet(uint64_t address) const {
+    if (config.dtcmEnabled && address >= config.dtcmBase && address < config.dtcmBase + config.dtcmSize) {
+        return -1;
+    }
+    int bankId = MemoryBank::getBankIndex(address, config.numMemoryBanks, config.bankIndexFn);
+    return config.bankToChiplet[bankId];
+}
+
+int ChipletAffinity::busiest(const std::vector<uint64_t>& counts) {
+    int home = -1;
+    uint64_t most = 0;
+    for (size_t c = 0; c < counts.size(); c++) {
+        if (counts[c] > most) {
+            most = counts[c];
+            home = static_cast<int>(c);
+        }
+    }
+    return home;
+}
+
+bool ChipletAffinity::usesExecutionIndex(OpSpan ops) const {
+    const AddressExprPool& exprs = graph.getAddressExprs();
+    for (const Op& op : ops) {
+        if (op.type == OpType::Memory && op.addrExpr >= 0 && exprs.usesVariable(op.addrExpr, 0)) {
+            return true;
+        }
+    }
+    return false;
+}
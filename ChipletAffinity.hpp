@@ -0,0 +1,70 @@
+#ifndef CHIPLETAFFINITY_HPP
+#define CHIPLETAFFINITY_HPP
+
+#include "Types.hpp"
+#include "Config.hpp"
+#include "TaskGraph.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * ChipletAffinity class
+ * Home chiplet of each task instance for the affinity policy: the chiplet
+ * whose memory banks serve most of the instance's accesses. The bank of an
+ * address is fixed by MemoryBank::getBankIndex and its chiplet by
+ * Config::bankToChiplet; DTCM addresses never leave the core and are not
+ * counted. Cache hits are not predicted, so the histogram counts every
+ * access that could reach a bank.
+ *
+ * Programs are walked once with their repeat blocks expanded, as Core runs
+ * them. Tasks whose addresses do not depend on the execution index i get
+ * one histogram up front; the others are walked again for each instance
+ * when it is dispatched.
+ */
+class ChipletAffinity {
+public:
+    /**
+     * Compute the home chiplet of every task that has one
+     * @param config Configuration with the bank-to-chiplet map
+     * @param graph Loaded task graph (outlives this object)
+     */
+    ChipletAffinity(const Config& config, const TaskGraph& graph);
+
+    /**
+     * Home chiplet of one instance
+     * @param taskIndex Task index (position in TaskGraph::getTasks())
+     * @param executionIndex Execution index of the instance
+     * @return Chiplet with the most bank accesses, or -1 if it makes none
+     */
+    int homeChiplet(int taskIndex, int32_t executionIndex) const;
+
+    /**
+     * Add the bank accesses of one execution of an op program per chiplet
+     * @param ops Op program
+     * @param executionIndex Value of i in address expressions
+     * @param counts Accesses per chiplet, numChiplets entries
+     */
+    void countAccesses(OpSpan ops, int32_t executionIndex, std::vector<uint64_t>& counts) const;
+
+    // Add the bank accesses of one replay of a trace per chiplet (one per line)
+    void countAccesses(const TraceFile& trace, std::vector<uint64_t>& counts) const;
+
+    // Chiplet of the bank serving an address, or -1 for DTCM addresses
+    int bankChiplet(uint64_t address) const;
+
+private:
+    static constexpr int kPerInstance = -2;
+
+    const Config& config;
+    const TaskGraph& graph;
+    std::vector<int> taskHome;              // Per task index; kPerInstance when i is used
+    mutable std::vector<uint64_t> scratch;  // Histogram of per-instance walks
+
+    // Chiplet with the most accesses (lowest id on ties), or -1 if none
+    static int busiest(const std::vector<uint64_t>& counts);
+
+    // Whether any memory op of the program reads the execution index
+    bool usesExecutionIndex(OpSpan ops) const;
+};
+
+#endif // CHIPLETAFFINITY_HPP
@@ -21,6 +21,19 @@ Config Config::loadFromFile(const std::string& filepath) {
             config.numChiplets = root->get("chiplets")->asInt();
         }
         
+        if (root->hasKey("core")) {
+            auto core = root->get("core");
+            if (core->hasKey("load_store_queue_depth")) {
+                config.lsqDepth = core->get("load_store_queue_depth")->asInt();
+            }
+            if (core->hasKey("thread_contexts")) {
+                config.threadContexts = core->get("thread_contexts")->asInt();
+            }
+            if (core->hasKey("context_switch_cycles")) {
+                config.contextSwitchCycles = core->get("context_switch_cycles")->asInt();
+            }
+        }
+        
         // Parse scheduling policy
         if (root->hasKey("scheduling_policy")) {
             config.schedulingPolicy = parseSchedulingPolicy(root->get("scheduling_policy")->asString());
@@ -102,11 +115,85 @@ Config Config::loadFromFile(const std::string& filepath) {
             }
         }
         
+        // Parse work-stealing configuration
+        if (root->hasKey("work_stealing")) {
+            auto stealing = root->get("work_stealing");
+            if (stealing->hasKey("victim")) {
+                config.stealVictim = parseStealVictim(stealing->get("victim")->asString());
+            }
+            if (stealing->hasKey("steal_latency_cycles")) {
+                config.stealLatency = stealing->get("steal_latency_cycles")->asInt();
+            }
+            if (stealing->hasKey("seed")) {
+                config.stealSeed = static_cast<uint32_t>(stealing->get("seed")->asInt());
+            }
+        }
+        
+        // Parse hierarchical scheduler configuration
+        if (root->hasKey("hierarchical_scheduler")) {
+            auto hierarchy = root->get("hierarchical_scheduler");
+            if (hierarchy->hasKey("dispatch_latency_cycles")) {
+                config.dispatchLatency = hierarchy->get("dispatch_latency_cycles")->asInt();
+            }
+            if (hierarchy->hasKey("dispatch_interval_cycles")) {
+                config.dispatchInterval = hierarchy->get("dispatch_interval_cycles")->asInt();
+            }
+            if (hierarchy->hasKey("migration_cycles")) {
+                config.migrationCost = hierarchy->get("migration_cycles")->asInt();
+            }
+        }
+        
+        // Parse bandwidth-aware admission configuration
+        if (root->hasKey("bandwidth_aware")) {
+            auto bandwidth = root->get("bandwidth_aware");
+            if (bandwidth->hasKey("memory_intensity")) {
+                config.memoryIntensity = bandwidth->get("memory_intensity")->asNumber();
+            }
+            if (bandwidth->hasKey("occupancy_threshold")) {
+                config.occupancyThreshold = bandwidth->get("occupancy_threshold")->asNumber();
+            }
+        }
+        
+        // Parse task instance configuration
+        if (root->hasKey("task_instances")) {
+            auto instances = root->get("task_instances");
+            if (instances->hasKey("materialization")) {
+                config.instanceMaterialization =
+                    parseInstanceMaterialization(instances->get("materialization")->asString());
+            }
+            if (instances->hasKey("ready_window")) {
+                config.lazyReadyWindow = instances->get("ready_window")->asInt();
+            }
+        }
+        
         // Parse system configuration
         if (root->hasKey("frequency_ghz")) {
             config.frequencyGHz = root->get("frequency_ghz")->asNumber();
         }
         
+        // Parse core classes; a class reaches the whole DTCM unless it says otherwise
+        if (root->hasKey("core_classes")) {
+            for (const JSONValue& entry : root->get("core_classes")->asArray()) {
+                CoreClass coreClass;
+                coreClass.name = std::string(entry.get("name")->asString());
+                coreClass.count = entry.get("count")->asInt();
+                coreClass.dtcmSize = config.dtcmSize;
+                if (entry.hasKey("compute_speed")) {
+                    coreClass.computeSpeed = entry.get("compute_speed")->asNumber();
+                }
+                if (entry.hasKey("dtcm_size_bytes")) {
+                    coreClass.dtcmSize = static_cast<uint64_t>(entry.get("dtcm_size_bytes")->asNumber());
+                }
+                if (entry.hasKey("op_types")) {
+                    coreClass.opTypes = 0;
+                    for (const JSONValue& type : entry.get("op_types")->asArray()) {
+                        coreClass.opTypes |= parseOpType(type.asString());
+                    }
+                }
+                config.coreClasses.push_back(std::move(coreClass));
+            }
+        }
+        
         // Initialize chiplet mappings
         config.initializeChipletMappings();
         
@@ -136,6 +223,47 @@ void Config::validate() const {
         throw std::runtime_error("Number of chiplets must be positive");
     }
     
+    // Validate core configuration
+    if (lsqDepth <= 0) {
+        throw std::runtime_error("Load/store queue depth must be positive");
+    }
+    if (threadContexts <= 0) {
+        throw std::runtime_error("Thread contexts per core must be positive");
+    }
+    if (contextSwitchCycles < 0) {
+        throw std::runtime_error("Context switch cycles cannot be negative");
+    }
+    
+    // Validate core classes; together they make up every core
+    if (!coreClasses.empty()) {
+        int classCores = 0;
+        for (size_t k = 0; k < coreClasses.size(); k++) {
+            const CoreClass& coreClass = coreClasses[k];
+            if (coreClass.count <= 0) {
+                throw std::runtime_error("Core class " + coreClass.name + " must have a positive count");
+            }
+            if (!(coreClass.computeSpeed > 0.0)) {
+                throw std::runtime_error("Core class " + coreClass.name + " compute speed must be positive");
+            }
+            if (coreClass.dtcmSize > dtcmSize) {
+                throw std::runtime_error("Core class " + coreClass.name + " DTCM exceeds the DTCM size");
+            }
+            if (coreClass.opTypes == 0) {
+                throw std::runtime_error("Core class " + coreClass.name + " executes no op types");
+            }
+            if (findCoreClass(coreClass.name) != static_cast<int>(k)) {
+                throw std::runtime_error("Duplicate core class: " + coreClass.name);
+            }
+            classCores += coreClass.count;
+        }
+        if (classCores != numCores) {
+            throw std::runtime_error("Core class counts must add up to the number of cores");
+        }
+        if (coreToClass.size() != static_cast<size_t>(numCores)) {
+            throw std::runtime_error("Core to class mapping size mismatch");
+        }
+    }
+    
     // Validate cache configuration
     if (cacheEnabled) {
         if (cacheSize <= 0) {
@@ -180,6 +308,29 @@ void Config::validate() const {
         throw std::runtime_error("Remote chiplet penalty cannot be negative");
     }
     
+    // Validate work-stealing configuration
+    if (stealLatency < 0) {
+        throw std::runtime_error("Steal latency cannot be negative");
+    }
+    
+    // Validate hierarchical scheduler configuration
+    if (dispatchLatency < 0 || dispatchInterval < 0 || migrationCost < 0) {
+        throw std::runtime_error("Scheduler dispatch and migration cycles cannot be negative");
+    }
+    
+    // Validate bandwidth-aware admission configuration
+    if (memoryIntensity < 0.0) {
+        throw std::runtime_error("Memory intensity threshold cannot be negative");
+    }
+    if (occupancyThreshold <= 0.0) {
+        throw std::runtime_error("Bank occupancy threshold must be positive");
+    }
+    
+    // Validate task instance configuration
+    if (lazyReadyWindow <= 0) {
+        throw std::runtime_error("Task instance ready window must be positive");
+    }
+    
     // Validate frequency
     if (frequencyGHz <= 0.0) {
         throw std::runtime_error("Frequency must be positive");
@@ -189,6 +340,9 @@ void Config::validate() const {
     if (coreToChiplet.size() != static_cast<size_t>(numCores)) {
         throw std::runtime_error("Core to chiplet mapping size mismatch");
     }
+    if (contextToChiplet.size() != static_cast<size_t>(getContextCount())) {
+        throw std::runtime_error("Context to chiplet mapping size mismatch");
+    }
     if (bankToChiplet.size() != static_cast<size_t>(numMemoryBanks)) {
         throw std::runtime_error("Bank to chiplet mapping size mismatch");
     }
@@ -213,6 +367,29 @@ int Config::getCoreChiplet(int coreId) const {
     return coreToChiplet[coreId];
 }
 
+int Config::getContextCore(int contextId) const {
+    if (contextId < 0 || contextId >= getContextCount()) {
+        throw std::runtime_error("Invalid context ID: " + std::to_string(contextId));
+    }
+    return contextId % numCores;
+}
+
+const CoreClass* Config::getCoreClass(int coreId) const {
+    if (coreId < 0 || coreId >= numCores) {
+        throw std::runtime_error("Invalid core ID: " + std::to_string(coreId));
+    }
+    return coreClasses.empty() ? nullptr : &coreClasses[coreToClass[coreId]];
+}
+
+int Config::findCoreClass(std::string_view name) const {
+    for (size_t k = 0; k < coreClasses.size(); k++) {
+        if (coreClasses[k].name == name) {
+            return static_cast<int>(k);
+        }
+    }
+    return -1;
+}
+
 int Config::getBankChiplet(int bankId) const {
     if (bankId < 0 || bankId >= numMemoryBanks) {
         throw std::runtime_error("Invalid bank ID: " + std::to_string(bankId));
@@ -220,8 +397,8 @@ int Config::getBankChiplet(int bankId) const {
     return bankToChiplet[bankId];
 }
 
-SchedulingPolicy Config::parseSchedulingPolicy(const std::string& str) {
-    std::string lower = str;
+SchedulingPolicy Config::parseSchedulingPolicy(std::string_view str) {
+    std::string lower(str);
     std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
     
     if (lower == "fifo") {
@@ -230,13 +407,27 @@ SchedulingPolicy Config::parseSchedulingPolicy(const std::string& str) {
         return SchedulingPolicy::RoundRobin;
     } else if (lower == "shortestopsfirst" || lower == "shortest_ops_first") {
         return SchedulingPolicy::ShortestOpsFirst;
+    } else if (lower == "criticalpath" || lower == "critical_path") {
+        return SchedulingPolicy::CriticalPath;
+    } else if (lower == "affinity") {
+        return SchedulingPolicy::Affinity;
+    } else if (lower == "workstealing" || lower == "work_stealing") {
+        return SchedulingPolicy::WorkStealing;
+    } else if (lower == "hierarchical") {
+        return SchedulingPolicy::Hierarchical;
+    } else if (lower == "bandwidthaware" || lower == "bandwidth_aware") {
+        return SchedulingPolicy::BandwidthAware;
+    } else if (lower == "edf" || lower == "earliest_deadline_first") {
+        return SchedulingPolicy::EarliestDeadline;
+    } else if (lower == "eft" || lower == "earliest_finish_time") {
+        return SchedulingPolicy::EarliestFinishTime;
     } else {
-        throw std::runtime_error("Unknown scheduling policy: " + str);
+        throw std::runtime_error("Unknown scheduling policy: " + std::string(str));
     }
 }
 
-BankIndexFunction Config::parseBankIndexFunction(const std::string& str) {
-    std::string lower = str;
+BankIndexFunction Config::parseBankIndexFunction(std::string_view str) {
+    std::string lower(str);
     std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
     
     if (lower == "addr_mod_n" || lower == "addressmodn") {
@@ -244,12 +435,12 @@ BankIndexFunction Config::parseBankIndexFunction(const std::string& str) {
     } else if (lower == "xor_fold" || lower == "xorfold") {
         return BankIndexFunction::XorFold;
     } else {
-        throw std::runtime_error("Unknown bank index function: " + str);
+        throw std::runtime_error("Unknown bank index function: " + std::string(str));
     }
 }
 
-BankConflictPolicy Config::parseBankConflictPolicy(const std::string& str) {
-    std::string lower = str;
+BankConflictPolicy Config::parseBankConflictPolicy(std::string_view str) {
+    std::string lower(str);
     std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
     
     if (lower == "serialize") {
@@ -259,12 +450,12 @@ BankConflictPolicy Config::parseBankConflictPolicy(const std::string& str) {
     } else if (lower == "extra_delay" || lower == "extradelay") {
         return BankConflictPolicy::ExtraDelay;
     } else {
-        throw std::runtime_error("Unknown bank conflict policy: " + str);
+        throw std::runtime_error("Unknown bank conflict policy: " + std::string(str));
     }
 }
 
-InterconnectTopology Config::parseInterconnectTopology(const std::string& str) {
-    std::string lower = str;
+InterconnectTopology Config::parseInterconnectTopology(std::string_view str) {
+    std::string lower(str);
     std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
     
     if (lower == "bus") {
@@ -272,7 +463,48 @@ InterconnectTopology Config::parseInterconnectTopology(const std::string& str) {
     } else if (lower == "mesh") {
         return InterconnectTopology::Mesh;
     } else {
-        throw std::runtime_error("Unknown interconnect topology: " + str);
+        throw std::runtime_error("Unknown interconnect topology: " + std::string(str));
+    }
+}
+
+InstanceMaterialization Config::parseInstanceMaterialization(std::string_view str) {
+    std::string lower(str);
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    
+    if (lower == "eager") {
+        return InstanceMaterialization::Eager;
+    } else if (lower == "lazy") {
+        return InstanceMaterialization::Lazy;
+    } else {
+        throw std::runtime_error("Unknown instance materialization: " + std::string(str));
+    }
+}
+
+StealVictim Config::parseStealVictim(std::string_view str) {
+    std::string lower(str);
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    
+    if (lower == "random") {
+        return StealVictim::Random;
+    } else if (lower == "chiplet") {
+        return StealVictim::Chiplet;
+    } else {
+        throw std::runtime_error("Unknown steal victim: " + std::string(str));
+    }
+}
+
+uint32_t Config::parseOpType(std::string_view str) {
+    std::string lower(str);
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    
+    if (lower == "compute") {
+        return opTypeBit(OpType::Compute);
+    } else if (lower == "mem" || lower == "memory") {
+        return opTypeBit(OpType::Memory);
+    } else if (lower == "fence") {
+        return opTypeBit(OpType::Fence);
+    } else {
+        throw std::runtime_error("Unknown op type: " + std::string(str));
     }
 }
 
@@ -283,8 +515,23 @@ void Config::initializeChipletMappings() {
         coreToChiplet[i] = i % numChiplets;
     }
     
+    // A context shares its core's chiplet
+    contextToChiplet.resize(std::max(getContextCount(), 0));
+    for (int c = 0; c < getContextCount(); c++) {
+        contextToChiplet[c] = coreToChiplet[c % numCores];
+    }
+    
     bankToChiplet.resize(numMemoryBanks);
     for (int i = 0; i < numMemoryBanks; i++) {
         bankToChiplet[i] = i % numChiplets;
     }
+    
+    // Core classes take consecutive cores in the order they are listed;
+    // validate() rejects counts that do not add up to numCores
+    coreToClass.clear();
+    for (size_t k = 0; k < coreClasses.size(); k++) {
+        for (int i = 0; i < coreClasses[k].count && static_cast<int>(coreToClass.size()) < numCores; i++) {
+            coreToClass.push_back(static_cast<int>(k));
+        }
+    }
 }
@@ -4,10 +4,22 @@
 #include "Types.hpp"
 #include "JSONParser.hpp"
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <vector>
 #include <cstdint>
 
+// A class of identical cores in a heterogeneous system
+struct CoreClass {
+    std::string name;
+    int count;               // Cores of this class
+    double computeSpeed;     // Compute op cycles are divided by this
+    uint64_t dtcmSize;       // DTCM bytes the class reaches from the DTCM base
+    uint32_t opTypes;        // opTypeBit of every op type the class executes
+
+    CoreClass() : count(0), computeSpeed(1.0), dtcmSize(0), opTypes(kAllOpTypes) {}
+};
+
 // Configuration structure for the simulator
 struct Config {
     // Core and chiplet configuration
@@ -15,6 +27,14 @@ struct Config {
     int numMemoryBanks;
     int numChiplets;
     
+    int lsqDepth;            // Memory requests a core keeps in flight (1: blocking)
+    int threadContexts;      // Hardware thread contexts per core, each running one instance
+    int contextSwitchCycles; // Cycles a core's pipeline loses switching between contexts
+    
+    // Heterogeneous core classes, assigned to cores in order; empty: all
+    // cores alike, at speed 1 with the whole DTCM and every op type
+    std::vector<CoreClass> coreClasses;
+    
     // Scheduling policy
     SchedulingPolicy schedulingPolicy;
     
@@ -44,16 +64,37 @@ struct Config {
     // Chiplet configuration
     int remoteChipletPenalty; // Additional cycles for inter-chiplet access
     
+    // Work-stealing configuration
+    StealVictim stealVictim;
+    int stealLatency;        // Cycles from a steal to the stolen instance's dispatch
+    uint32_t stealSeed;      // Seed of the random victim choice
+    
+    // Hierarchical scheduler configuration
+    int dispatchLatency;     // Cycles from a dispatch decision to the instance's start
+    int dispatchInterval;    // Cycles a chiplet scheduler is busy per dispatch (1 / throughput)
+    int migrationCost;       // Cycles the balancer spends moving an instance between chiplets
+    
+    // Bandwidth-aware admission configuration
+    double memoryIntensity;     // Memory ops per cycle at which an instance counts as memory-bound
+    double occupancyThreshold;  // In-flight bank requests per bank port that stop memory-bound dispatch
+    
+    // Task instance materialization
+    InstanceMaterialization instanceMaterialization;
+    int lazyReadyWindow;     // Ready instances kept materialized beyond the running ones
+    
     // System configuration
     double frequencyGHz;     // Clock frequency for time conversion
     
     // Chiplet mapping vectors (computed during initialization)
     std::vector<int> coreToChiplet;
+    std::vector<int> contextToChiplet;  // Per hardware thread context
     std::vector<int> bankToChiplet;
+    std::vector<int> coreToClass;       // Index into coreClasses; empty without classes
     
     // Default constructor
     Config() 
-        : numCores(1), numMemoryBanks(1), numChiplets(1),
+        : numCores(1), numMemoryBanks(1), numChiplets(1), lsqDepth(1),
+          threadContexts(1), contextSwitchCycles(0),
           schedulingPolicy(SchedulingPolicy::FIFO),
           cacheEnabled(false), cacheSize(0), cacheHitLatency(0), cachePortLimit(1),
           dtcmEnabled(false), dtcmBase(0), dtcmSize(0), dtcmLatency(0),
@@ -61,7 +102,12 @@ struct Config {
           bankConflictPolicy(BankConflictPolicy::Serialize), bankPortLimit(1),
           interconnectTopology(InterconnectTopology::Bus),
           interconnectLatency(0), interconnectLinkWidth(8),
-          remoteChipletPenalty(0), frequencyGHz(1.0) {}
+          remoteChipletPenalty(0),
+          stealVictim(StealVictim::Random), stealLatency(0), stealSeed(1),
+          dispatchLatency(0), dispatchInterval(0), migrationCost(0),
+          memoryIntensity(0.01), occupancyThreshold(1.0),
+          instanceMaterialization(InstanceMaterialization::Eager), lazyReadyWindow(64),
+          frequencyGHz(1.0) {}
     
     // Load configuration from JSON file
     static Config loadFromFile(const std::string& filepath);
@@ -74,15 +120,31 @@ struct Config {
     
     // Get chiplet ID for a bank
     int getBankChiplet(int bankId) const;
+    
+    // Hardware thread contexts over all cores; the scheduler dispatches to contexts
+    int getContextCount() const { return numCores * threadContexts; }
+    
+    // Core of a hardware thread context. Context c runs on core c % numCores,
+    // so the first numCores contexts are one per core.
+    int getContextCore(int contextId) const;
+    
+    // Class of a core, or nullptr when no classes are configured
+    const CoreClass* getCoreClass(int coreId) const;
+    
+    // Index of the core class with this name, -1 if there is none
+    int findCoreClass(std::string_view name) const;
 
 private:
     // Helper methods for parsing
-    static SchedulingPolicy parseSchedulingPolicy(const std::string& str);
-    static BankIndexFunction parseBankIndexFunction(const std::string& str);
-    static BankConflictPolicy parseBankConflictPolicy(const std::string& str);
-    static InterconnectTopology parseInterconnectTopology(const std::string& str);
+    static SchedulingPolicy parseSchedulingPolicy(std::string_view str);
+    static BankIndexFunction parseBankIndexFunction(std::string_view str);
+    static BankConflictPolicy parseBankConflictPolicy(std::string_view str);
+    static InterconnectTopology parseInterconnectTopology(std::string_view str);
+    static InstanceMaterialization parseInstanceMaterialization(std::string_view str);
+    static StealVictim parseStealVictim(std::string_view str);
+    static uint32_t parseOpType(std::string_view str);
     
-    // Initialize chiplet mappings
+    // Initialize chiplet and core class mappings
     void initializeChipletMappings();
 };
 
@@ -1,9 +1,14 @@
 #include "Core.hpp"
+#include <algorithm>
+#include <climits>
 #include <stdexcept>
 
 // Constructor
-Core::Core(int coreId)
-    : coreId(coreId), busy(false), currentInstanceId(-1), busySince(0) {
+Core::Core(int coreId, int lsqDepth, Pipeline* pipeline)
+    : coreId(coreId), lsqDepth(std::max(lsqDepth, 1)), pipeline(pipeline), busy(false),
+      currentInstanceId(-1), busySince(0), busyCycles(0), computing(false), outstandingLoads(0), outstandingStores(0),
+      exprVars{}, loopDepth(0), trace(nullptr), traceLength(0), traceGapDone(false),
+      traceNextAccess(0) {
 }
 
 // Subtask 7.1: Check if core is idle
@@ -11,81 +16,213 @@ bool Core::isIdle() const {
     return !busy;
 }
 
-// Subtask 7.2: Execute an operation from a task instance
-void Core::executeOp(const Op& op, int instanceId, uint64_t currentTime, 
-                     EventQueue& eventQueue, TaskGraph& taskGraph) {
+// Reset loop state for a newly dispatched instance and issue its first ops
+void Core::startInstance(int instanceId, uint64_t currentTime,
+                         EventQueue& eventQueue, TaskGraph& taskGraph) {
     if (busy) {
-        throw std::runtime_error("Cannot execute operation on busy core");
+        throw std::runtime_error("Cannot start an instance on a busy core");
     }
-    
-    // Mark core as busy
+
     busy = true;
     currentInstanceId = instanceId;
     busySince = currentTime;
-    
-    // Route to appropriate handler based on operation type
-    if (op.type == OpType::Compute) {
-        handleComputeOp(op, instanceId, currentTime, eventQueue);
-    } else if (op.type == OpType::Memory) {
-        handleMemoryOp(op, instanceId, currentTime, eventQueue);
+
+    // Trace-bound tasks replay records straight from the mapped file
+    InstanceTable& instances = taskGraph.getInstances();
+    const TraceFile* traceFile = taskGraph.getTrace(instances.taskId(instanceId));
+    if (traceFile != nullptr) {
+        trace = traceFile->records();
+        traceLength = static_cast<int32_t>(traceFile->size());
+        traceGapDone = false;
     } else {
-        throw std::runtime_error("Unknown operation type");
+        trace = nullptr;
+        exprVars[0] = instances.executionIndex(instanceId);
+        loopDepth = 0;
     }
+
+    issueOps(currentTime, eventQueue, taskGraph);
 }
 
 // Subtask 7.2: Handle compute operation
-void Core::handleComputeOp(const Op& op, int instanceId, uint64_t currentTime, 
-                           EventQueue& eventQueue) {
-    // Schedule ComputeDone event at now + op.cycles
-    Event computeDoneEvent(EventType::ComputeDone, currentTime + op.cycles, 
-                          coreId, instanceId);
+void Core::handleComputeOp(int cycles, uint64_t currentTime, EventQueue& eventQueue) {
+    // Schedule ComputeDone event once the pipeline has run the op; the core
+    // issues nothing meanwhile
+    computing = true;
+    uint64_t doneTime = pipeline != nullptr ? pipeline->reserve(coreId, currentTime, cycles)
+                                            : currentTime + cycles;
+    Event computeDoneEvent(EventType::ComputeDone, doneTime, coreId, currentInstanceId);
     eventQueue.push(computeDoneEvent);
 }
 
 // Subtask 7.2: Handle memory operation
-void Core::handleMemoryOp(const Op& op, int instanceId, uint64_t currentTime, 
+void Core::handleMemoryOp(uint64_t address, AccessType rw, uint64_t currentTime,
                           EventQueue& eventQueue) {
-    // Schedule MemReqIssued event immediately
-    Event memReqEvent(EventType::MemReqIssued, currentTime, coreId, instanceId, 
-                     op.address, static_cast<int>(op.rw));
+    // Take a queue entry and schedule MemReqIssued event immediately
+    if (rw == AccessType::Write) {
+        outstandingStores++;
+    } else {
+        outstandingLoads++;
+    }
+    Event memReqEvent(EventType::MemReqIssued, currentTime, coreId, currentInstanceId,
+                     address, static_cast<int>(rw));
     eventQueue.push(memReqEvent);
 }
 
+// Whether an op may issue with the current requests in flight. Ops carry
+// no register operands, so a compute op conservatively consumes every
+// outstanding load; stores retire in the background unless the core blocks.
+bool Core::mayIssue(OpType type) const {
+    switch (type) {
+        case OpType::Compute:
+            return outstandingLoads == 0 && (lsqDepth > 1 || outstandingStores == 0);
+        case OpType::Memory:
+            return outstandingLoads + outstandingStores < lsqDepth;
+        default:
+            return outstandingLoads + outstandingStores == 0;  // Fence
+    }
+}
+
+// Issue ops of the running instance until one has to wait; once the program
+// has ended, the instance completes with its last outstanding response
+void Core::issueOps(uint64_t currentTime, EventQueue& eventQueue, TaskGraph& taskGraph) {
+    InstanceTable& instances = taskGraph.getInstances();
+    bool pending = trace != nullptr ? issueTrace(instances, currentTime, eventQueue)
+                                    : issueProgram(instances, currentTime, eventQueue, taskGraph);
+    if (!pending && outstandingLoads + outstandingStores == 0) {
+        finishInstance(instances, currentTime, eventQueue);
+    }
+}
+
+// Issue program ops from the instance's op index on. Returns false once the
+// program has ended, true while ops wait on a compute op or the queue.
+bool Core::issueProgram(InstanceTable& instances, uint64_t currentTime, EventQueue& eventQueue,
+                        TaskGraph& taskGraph) {
+    OpSpan ops = taskGraph.getOps(instances.taskId(currentInstanceId));
+    int32_t& opIndex = instances.opIndex(currentInstanceId);
+
+    while (skipControlOps(opIndex, ops)) {
+        const Op& op = ops[opIndex];
+        if (!mayIssue(op.type)) {
+            return true;
+        }
+        opIndex++;
+
+        // Route to appropriate handler based on operation type
+        if (op.type == OpType::Compute) {
+            handleComputeOp(op.cycles, currentTime, eventQueue);
+            return true;
+        } else if (op.type == OpType::Memory) {
+            // Resolve before skipControlOps moves the loop counters on
+            handleMemoryOp(taskGraph.resolveAddress(op, exprVars), op.rw, currentTime, eventQueue);
+        }
+        // A fence only waits for the queue to drain
+    }
+
+    return false;
+}
+
+// Step over Repeat/EndRepeat ops, updating loop counters, until opIndex
+// points at a compute, memory or fence op. Returns false once the program has ended.
+bool Core::skipControlOps(int32_t& opIndex, OpSpan ops) {
+    int numOps = static_cast<int>(ops.size());
+
+    while (opIndex < numOps) {
+        const Op& op = ops[opIndex];
+
+        if (op.type == OpType::Repeat) {
+            exprVars[1 + loopDepth] = 0;
+            loopDepth++;
+            opIndex++;
+        } else if (op.type == OpType::EndRepeat) {
+            // EndRepeat::cycles holds the index of the matching Repeat
+            int repeatIdx = op.cycles;
+            if (++exprVars[loopDepth] < ops[repeatIdx].cycles) {
+                opIndex = repeatIdx + 1;
+            } else {
+                loopDepth--;
+                opIndex++;
+            }
+        } else {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Issue the gap and the line accesses of trace records. The instance's op
+// index is its record index; returns false once the trace has ended.
+bool Core::issueTrace(InstanceTable& instances, uint64_t currentTime, EventQueue& eventQueue) {
+    int32_t& recordIndex = instances.opIndex(currentInstanceId);
+
+    while (recordIndex < traceLength) {
+        const TraceRecord& record = trace[recordIndex];
+
+        if (!traceGapDone) {
+            if (record.gap > 0 && !mayIssue(OpType::Compute)) {
+                return true;
+            }
+            traceGapDone = true;
+            traceNextAccess = record.address;
+            if (record.gap > 0) {
+                int cycles = static_cast<int>(std::min<uint32_t>(record.gap, INT_MAX));
+                handleComputeOp(cycles, currentTime, eventQueue);
+                return true;
+            }
+        }
+
+        // One request per line the record touches; later lines start line-aligned
+        uint64_t end = record.address + std::max<uint16_t>(record.size, 1);
+        if (traceNextAccess < end) {
+            if (!mayIssue(OpType::Memory)) {
+                return true;
+            }
+            uint64_t address = traceNextAccess;
+            traceNextAccess = (address / kTraceLineBytes + 1) * kTraceLineBytes;
+            AccessType rw = record.rw != 0 ? AccessType::Write : AccessType::Read;
+            handleMemoryOp(address, rw, currentTime, eventQueue);
+            continue;
+        }
+
+        recordIndex++;
+        traceGapDone = false;
+    }
+
+    return false;
+}
+
+// Schedule TaskDone for the running instance and return the core to idle
+void Core::finishInstance(InstanceTable& instances, uint64_t currentTime, EventQueue& eventQueue) {
+    instances.doneTime(currentInstanceId) = currentTime;
+    Event taskDoneEvent(EventType::TaskDone, currentTime, coreId, currentInstanceId);
+    eventQueue.push(taskDoneEvent);
+
+    // Reset core to idle state
+    busyCycles += currentTime - busySince;
+    busy = false;
+    currentInstanceId = -1;
+}
+
 // Subtask 7.3: Complete operation and advance to next
 void Core::completeOp(uint64_t currentTime, EventQueue& eventQueue, TaskGraph& taskGraph) {
-    if (!busy || currentInstanceId == -1) {
+    if (!busy || !computing) {
         throw std::runtime_error("Cannot complete operation on idle core");
     }
-    
-    // Get the current task instance
-    TaskInstance& instance = taskGraph.getInstance(currentInstanceId);
-    
-    // Advance to next operation
-    instance.currentOpIndex++;
-    
-    // Get the operations for this task
-    const std::vector<Op>& ops = taskGraph.getOps(instance.taskId);
-    
-    // Check if all operations are complete
-    if (instance.currentOpIndex >= static_cast<int>(ops.size())) {
-        // All operations complete - schedule TaskDone event
-        instance.doneTime = currentTime;
-        Event taskDoneEvent(EventType::TaskDone, currentTime, coreId, currentInstanceId);
-        eventQueue.push(taskDoneEvent);
-        
-        // Reset core to idle state
-        busy = false;
-        currentInstanceId = -1;
-    } else {
-        // More operations to execute - execute the next one
-        const Op& nextOp = ops[instance.currentOpIndex];
-        
-        // Temporarily mark as not busy so executeOp can proceed
-        busy = false;
-        int instanceId = currentInstanceId;
-        currentInstanceId = -1;
-        
-        // Execute the next operation
-        executeOp(nextOp, instanceId, currentTime, eventQueue, taskGraph);
+
+    computing = false;
+    issueOps(currentTime, eventQueue, taskGraph);
+}
+
+// Retire a memory request; ops waiting on it issue unless a compute op is running
+void Core::completeMemoryOp(AccessType rw, uint64_t currentTime, EventQueue& eventQueue,
+                            TaskGraph& taskGraph) {
+    int& outstanding = rw == AccessType::Write ? outstandingStores : outstandingLoads;
+    if (!busy || outstanding == 0) {
+        throw std::runtime_error("Memory response without an outstanding request");
+    }
+
+    outstanding--;
+    if (!computing) {
+        issueOps(currentTime, eventQueue, taskGraph);
     }
 }
@@ -4,36 +4,123 @@
 #include "Types.hpp"
 #include "EventQueue.hpp"
 #include "TaskGraph.hpp"
+#include <cmath>
 #include <cstdint>
 
+/**
+ * Pipeline struct
+ * Execution pipeline shared by the hardware thread contexts of one core.
+ * Compute ops of its contexts run one at a time in issue order, so while a
+ * context waits on memory the others compute. Starting an op of a different
+ * context than the last one costs switchCycles first. A core class with a
+ * compute speed other than 1 runs an op of n cycles in ceil(n / speed).
+ */
+struct Pipeline {
+    int switchCycles;
+    double speed;             // Compute speed of the core's class
+    int lastContext;          // Context of the last compute op, -1 before the first
+    uint64_t freeAt;          // Cycle the last reserved compute op finishes
+    uint64_t busyCycles;      // Cycles computing or switching
+    uint64_t switchingCycles; // Of which switching between contexts
+
+    explicit Pipeline(int switchCycles = 0, double speed = 1.0)
+        : switchCycles(switchCycles), speed(speed), lastContext(-1), freeAt(0), busyCycles(0),
+          switchingCycles(0) {}
+
+    // Reserve the pipeline for a compute op issued at readyTime; returns when it finishes
+    uint64_t reserve(int contextId, uint64_t readyTime, int cycles) {
+        uint64_t start = readyTime > freeAt ? readyTime : freeAt;
+        if (lastContext != contextId && lastContext != -1) {
+            start += switchCycles;
+            busyCycles += switchCycles;
+            switchingCycles += switchCycles;
+        }
+        uint64_t run = speed == 1.0 ? static_cast<uint64_t>(cycles)
+                                    : static_cast<uint64_t>(std::ceil(cycles / speed));
+        lastContext = contextId;
+        freeAt = start + run;
+        busyCycles += run;
+        return freeAt;
+    }
+};
+
+/**
+ * Core class
+ * In-order core running one task instance at a time. Memory ops issue into
+ * a load/store queue of lsqDepth entries and the core moves on to the next
+ * op while they are in flight; a compute op waits for the outstanding loads
+ * it may consume, a fence for every outstanding request, and the instance
+ * completes with its last response. With a depth of 1 every op waits for
+ * the previous memory op, as on a blocking core.
+ *
+ * With hardware multithreading each Core object is one thread context, and
+ * the contexts of a physical core share its Pipeline.
+ */
 class Core {
 public:
-    Core(int coreId);
-    
+    /**
+     * @param coreId Id of this core (the context id under multithreading)
+     * @param lsqDepth Load/store queue entries
+     * @param pipeline Pipeline shared with other contexts (outlives the core), or nullptr
+     */
+    Core(int coreId, int lsqDepth = 1, Pipeline* pipeline = nullptr);
+
     // Check if core is idle
     bool isIdle() const;
-    
-    // Execute an operation from a task instance
-    void executeOp(const Op& op, int instanceId, uint64_t currentTime, 
-                   EventQueue& eventQueue, TaskGraph& taskGraph);
-    
-    // Complete the current operation and advance to next
+
+    // Begin executing a dispatched task instance from its first operation
+    void startInstance(int instanceId, uint64_t currentTime,
+                       EventQueue& eventQueue, TaskGraph& taskGraph);
+
+    // Complete the running compute operation and issue the ops after it
     void completeOp(uint64_t currentTime, EventQueue& eventQueue, TaskGraph& taskGraph);
-    
+
+    // Retire an outstanding memory request and issue the ops it held back
+    void completeMemoryOp(AccessType rw, uint64_t currentTime, EventQueue& eventQueue,
+                          TaskGraph& taskGraph);
+
     // Getters
     int getCoreId() const { return coreId; }
     int getCurrentInstanceId() const { return currentInstanceId; }
     uint64_t getBusySince() const { return busySince; }
-    
+    int getOutstandingRequests() const { return outstandingLoads + outstandingStores; }
+    uint64_t getBusyCycles() const { return busyCycles; }
+
 private:
     int coreId;
+    int lsqDepth;               // Memory requests in flight at once
+    Pipeline* pipeline;         // Shared with the core's other contexts; null: own pipeline
     bool busy;
     int currentInstanceId;
     uint64_t busySince;
-    
+    uint64_t busyCycles;        // Cycles spent running instances
+
+    // Issue state of the running instance
+    bool computing;             // A compute op is running
+    int outstandingLoads;
+    int outstandingStores;
+
+    // Address expression variables of the running instance: i, then one
+    // counter per open repeat block
+    int64_t exprVars[1 + kMaxLoopDepth];
+    int loopDepth;
+
+    // Trace replay state of the running instance; trace is null for op programs
+    const TraceRecord* trace;
+    int32_t traceLength;
+    bool traceGapDone;          // Gap of the current record has been issued
+    uint64_t traceNextAccess;   // Next line access of the current record
+
     // Helper methods for operation execution
-    void handleComputeOp(const Op& op, int instanceId, uint64_t currentTime, EventQueue& eventQueue);
-    void handleMemoryOp(const Op& op, int instanceId, uint64_t currentTime, EventQueue& eventQueue);
+    bool skipControlOps(int32_t& opIndex, OpSpan ops);
+    bool mayIssue(OpType type) const;
+    void issueOps(uint64_t currentTime, EventQueue& eventQueue, TaskGraph& taskGraph);
+    bool issueProgram(InstanceTable& instances, uint64_t currentTime, EventQueue& eventQueue,
+                      TaskGraph& taskGraph);
+    bool issueTrace(InstanceTable& instances, uint64_t currentTime, EventQueue& eventQueue);
+    void finishInstance(InstanceTable& instances, uint64_t currentTime, EventQueue& eventQueue);
+    void handleComputeOp(int cycles, uint64_t currentTime, EventQueue& eventQueue);
+    void handleMemoryOp(uint64_t address, AccessType rw, uint64_t currentTime, EventQueue& eventQueue);
 };
 
 #endif // CORE_HPP
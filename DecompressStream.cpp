@@ -0,0 +1,222 @@
+#include "DecompressStream.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// Output grown per decoder call
+static const size_t kOutputStep = 256 * 1024;
+
+Compression DecompressStream::detect(const MappedFile& file) {
+    const auto* magic = reinterpret_cast<const unsigned char*>(file.data());
+    if (file.size() >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        return Compression::Gzip;
+    }
+    if (file.size() >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+        return Compression::Zstd;
+    }
+    return Compression::None;
+}
+
+DecompressStream::DecompressStream(const MappedFile& file, Compression format,
+                                   size_t chunkBytes, size_t queueDepth)
+    : file(file), format(format), chunkBytes(chunkBytes), queueDepth(queueDepth) {
+#ifndef HAVE_ZLIB
+    if (format == Compression::Gzip) {
+        throw std::runtime_error(file.path() + " is gzip-compressed, but this build has no zlib support");
+    }
+#endif
+#ifndef HAVE_ZSTD
+    if (format == Compression::Zstd) {
+        throw std::runtime_error(file.path() + " is zstd-compressed, but this build has no zstd support");
+    }
+#endif
+    if (format == Compression::None) {
+        throw std::runtime_error(file.path() + " is not compressed");
+    }
+    worker = std::thread(&DecompressStream::run, this);
+}
+
+DecompressStream::~DecompressStream() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+    }
+    notFull.notify_all();
+    worker.join();
+}
+
+bool DecompressStream::next(std::string& chunk) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [this] { return !queue.empty() || finished; });
+
+    if (!queue.empty()) {
+        chunk = std::move(queue.front());
+        queue.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+    if (error) {
+        std::exception_ptr failure = error;
+        error = nullptr;
+        std::rethrow_exception(failure);
+    }
+    return false;
+}
+
+std::string DecompressStream::readAll() {
+    std::string text;
+    std::string chunk;
+    while (next(chunk)) {
+        text += chunk;
+    }
+    return text;
+}
+
+void DecompressStream::run() {
+    try {
+        if (format == Compression::Gzip) {
+            inflateGzip();
+        } else {
+            decompressZstd();
+        }
+    } catch (const std::exception& e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = std::make_exception_ptr(
+            std::runtime_error("Failed to decompress " + file.path() + ": " + e.what()));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    notEmpty.notify_all();
+}
+
+bool DecompressStream::push(std::string&& chunk) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notFull.wait(lock, [this] { return queue.size() < queueDepth || cancelled; });
+    if (cancelled) {
+        return false;
+    }
+    queue.push_back(std::move(chunk));
+    notEmpty.notify_one();
+    return true;
+}
+
+bool DecompressStream::emit(std::string& pending, bool last) {
+    if (last) {
+        return pending.empty() || push(std::move(pending));
+    }
+    if (pending.size() < chunkBytes) {
+        return true;
+    }
+
+    // Cut after the last complete line; a longer line keeps accumulating
+    size_t cut = pending.rfind('\n');
+    if (cut == std::string::npos) {
+        return true;
+    }
+    std::string chunk = std::move(pending);
+    pending.assign(chunk, cut + 1, std::string::npos);
+    chunk.resize(cut + 1);
+    return push(std::move(chunk));
+}
+
+void DecompressStream::inflateGzip() {
+#ifdef HAVE_ZLIB
+    z_stream strm = {};
+    if (inflateInit2(&strm, 15 + 32) != Z_OK) {  // 15-bit window, gzip or zlib header
+        throw std::runtime_error("inflateInit failed");
+    }
+    struct Guard {
+        z_stream& strm;
+        ~Guard() { inflateEnd(&strm); }
+    } guard{strm};
+
+    // avail_in is 32-bit; feed large files in pieces
+    const auto* input = reinterpret_cast<const Bytef*>(file.data());
+    size_t inputLeft = file.size();
+    std::string pending;
+
+    while (true) {
+        if (strm.avail_in == 0 && inputLeft > 0) {
+            uInt piece = static_cast<uInt>(std::min<size_t>(inputLeft, 1u << 30));
+            strm.next_in = const_cast<Bytef*>(input);
+            strm.avail_in = piece;
+            input += piece;
+            inputLeft -= piece;
+        }
+
+        size_t used = pending.size();
+        pending.resize(used + kOutputStep);
+        strm.next_out = reinterpret_cast<Bytef*>(&pending[used]);
+        strm.avail_out = static_cast<uInt>(kOutputStep);
+        int rc = inflate(&strm, Z_NO_FLUSH);
+        pending.resize(used + kOutputStep - strm.avail_out);
+
+        if (rc == Z_STREAM_END) {
+            if (strm.avail_in == 0 && inputLeft == 0) {
+                break;
+            }
+            inflateReset(&strm);  // Concatenated gzip members continue the text
+        } else if (rc == Z_BUF_ERROR && strm.avail_in == 0 && inputLeft == 0) {
+            throw std::runtime_error("unexpected end of compressed data");
+        } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+            throw std::runtime_error(strm.msg != nullptr ? strm.msg : "corrupt compressed data");
+        }
+
+        if (!emit(pending, false)) {
+            return;
+        }
+    }
+    emit(pending, true);
+#endif
+}
+
+void DecompressStream::decompressZstd() {
+#ifdef HAVE_ZSTD
+    ZSTD_DStream* stream = ZSTD_createDStream();
+    if (stream == nullptr) {
+        throw std::runtime_error("ZSTD_createDStream failed");
+    }
+    struct Guard {
+        ZSTD_DStream* stream;
+        ~Guard() { ZSTD_freeDStream(stream); }
+    } guard{stream};
+    ZSTD_initDStream(stream);
+
+    ZSTD_inBuffer input = {file.data(), file.size(), 0};
+    std::string pending;
+    size_t hint = 0;  // Nonzero while a frame is incomplete
+
+    while (true) {
+        size_t used = pending.size();
+        pending.resize(used + kOutputStep);
+        ZSTD_outBuffer output = {&pending[used], kOutputStep, 0};
+        hint = ZSTD_decompressStream(stream, &output, &input);
+        if (ZSTD_isError(hint)) {
+            throw std::runtime_error(ZSTD_getErrorName(hint));
+        }
+        pending.resize(used + output.pos);
+
+        // Done once all input is consumed and the decoder has flushed
+        if (input.pos == input.size && output.pos < kOutputStep) {
+            break;
+        }
+        if (!emit(pending, false)) {
+            return;
+        }
+    }
+    if (hint != 0) {
+        throw std::runtime_error("unexpected end of compressed data");
+    }
+    emit(pending, true);
+#endif
+}
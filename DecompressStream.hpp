@@ -0,0 +1,82 @@
+#ifndef DECOMPRESSSTREAM_HPP
+#define DECOMPRESSSTREAM_HPP
+
+#include "MappedFile.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Compression format of an input file, detected from its magic bytes
+enum class Compression {
+    None,
+    Gzip,   // Needs a build with zlib (HAVE_ZLIB)
+    Zstd    // Needs a build with libzstd (HAVE_ZSTD)
+};
+
+/**
+ * DecompressStream class
+ * Decompresses a mapped file on a worker thread and hands the text to the
+ * caller as line-aligned chunks through a bounded queue, so decompression
+ * overlaps parsing and at most a few chunks are held in memory.
+ */
+class DecompressStream {
+public:
+    static constexpr size_t kDefaultChunkBytes = 4 << 20;
+    static constexpr size_t kDefaultQueueDepth = 4;
+
+    // Format of a mapped file; None for anything not recognized
+    static Compression detect(const MappedFile& file);
+
+    /**
+     * Start decompressing
+     * @param file Compressed input; must outlive the stream
+     * @param format Format returned by detect() (not None)
+     * @param chunkBytes Target chunk size; chunks end after a '\n' unless a line is longer
+     * @param queueDepth Chunks decompressed ahead of the consumer
+     */
+    DecompressStream(const MappedFile& file, Compression format,
+                     size_t chunkBytes = kDefaultChunkBytes, size_t queueDepth = kDefaultQueueDepth);
+    ~DecompressStream();
+
+    DecompressStream(const DecompressStream&) = delete;
+    DecompressStream& operator=(const DecompressStream&) = delete;
+
+    /**
+     * Take the next chunk, waiting for the worker if needed
+     * @param chunk Replaced by the chunk's text
+     * @return False once the input is exhausted; decompression errors are thrown
+     */
+    bool next(std::string& chunk);
+
+    // Decompress the remaining input into one string
+    std::string readAll();
+
+private:
+    const MappedFile& file;
+    Compression format;
+    size_t chunkBytes;
+    size_t queueDepth;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    std::deque<std::string> queue;
+    bool finished = false;              // Worker pushed its last chunk
+    bool cancelled = false;             // Consumer stopped early
+    std::exception_ptr error;           // Worker failure, rethrown by next()
+
+    void run();
+    void inflateGzip();
+    void decompressZstd();
+
+    // Split complete lines off pending and queue them; returns false if cancelled
+    bool emit(std::string& pending, bool last);
+    bool push(std::string&& chunk);
+};
+
+#endif // DECOMPRESSSTREAM_HPP
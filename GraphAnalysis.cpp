@@ -0,0 +1,228 @@
+#include "GraphAnalysis.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Bytes moved per bank access, matching MemorySystem::handleBankAccess
+static const int kLineSize = 64;
+
+GraphAnalysis::GraphAnalysis(const Config& config, int coreClass)
+    : config(config), computeSpeed(1.0), dtcmSize(config.dtcmSize) {
+    if (coreClass >= 0) {
+        computeSpeed = config.coreClasses.at(coreClass).computeSpeed;
+        dtcmSize = config.coreClasses.at(coreClass).dtcmSize;
+    } else if (!config.coreClasses.empty()) {
+        computeSpeed = config.coreClasses[0].computeSpeed;
+        for (const CoreClass& other : config.coreClasses) {
+            computeSpeed = std::max(computeSpeed, other.computeSpeed);
+        }
+    }
+
+    // Local bank access: interconnect base + serialization + bank service
+    uint64_t bankLatency = config.interconnectLatency + config.bankServiceLatency;
+    if (config.interconnectLinkWidth > 0) {
+        bankLatency += (kLineSize + config.interconnectLinkWidth - 1) / config.interconnectLinkWidth;
+    }
+
+    offChipLatency = bankLatency;
+    if (config.cacheEnabled) {
+        offChipLatency = std::min<uint64_t>(offChipLatency, config.cacheHitLatency);
+    }
+}
+
+uint64_t GraphAnalysis::minMemoryLatency(const Op& op) const {
+    if (config.dtcmEnabled && dtcmSize > 0 && op.addrExpr >= 0) {
+        // Computed addresses may land in either region
+        return std::min<uint64_t>(config.dtcmLatency, offChipLatency);
+    }
+    return minMemoryLatency(op.address);
+}
+
+uint64_t GraphAnalysis::minMemoryLatency(uint64_t address) const {
+    bool inDTCM = config.dtcmEnabled && address >= config.dtcmBase &&
+                  address - config.dtcmBase < dtcmSize;
+    return inDTCM ? static_cast<uint64_t>(config.dtcmLatency) : offChipLatency;
+}
+
+uint64_t GraphAnalysis::instanceCost(OpSpan ops, uint64_t* memoryOps) const {
+    // Multiplier of the innermost enclosing repeat block at each depth
+    uint64_t multiplier[kMaxLoopDepth + 1];
+    int depth = 0;
+    multiplier[0] = 1;
+
+    uint64_t compute = 0;
+    uint64_t latency[2] = {0, 0};  // Loads, stores
+    uint64_t accesses = 0;
+    for (const Op& op : ops) {
+        switch (op.type) {
+            case OpType::Compute:
+                compute += multiplier[depth] * static_cast<uint64_t>(op.cycles);
+                break;
+            case OpType::Memory:
+                latency[op.rw == AccessType::Write] += multiplier[depth] * minMemoryLatency(op);
+                accesses += multiplier[depth];
+                break;
+            case OpType::Repeat:
+                multiplier[depth + 1] = multiplier[depth] * static_cast<uint64_t>(op.cycles);
+                depth++;
+                break;
+            case OpType::EndRepeat:
+                depth--;
+                break;
+            case OpType::Fence:
+                break;
+        }
+    }
+
+    if (memoryOps != nullptr) {
+        *memoryOps = accesses;
+    }
+    return combine(compute, latency[0], latency[1]);
+}
+
+uint64_t GraphAnalysis::traceCost(const TraceFile& trace, uint64_t* memoryOps) const {
+    std::atomic<uint64_t> compute{0};
+    std::atomic<uint64_t> latency[2] = {{0}, {0}};  // Loads, stores
+    std::atomic<uint64_t> accesses{0};
+    const TraceRecord* records = trace.records();
+
+    // One sequential pass over the mapping, split across workers
+    parallelFor(trace.size(), 1 << 20, [&](size_t begin, size_t end) {
+        uint64_t partialCompute = 0;
+        uint64_t partialLatency[2] = {0, 0};
+        uint64_t partialLines = 0;
+        for (size_t r = begin; r < end; r++) {
+            const TraceRecord& record = records[r];
+            partialCompute += record.gap;
+
+            // The first line keeps the record's address, as Core issues it
+            uint64_t lines = TraceFile::lineCount(record);
+            uint64_t lineBase = record.address / kTraceLineBytes * kTraceLineBytes;
+            uint64_t& recordLatency = partialLatency[record.rw != 0];
+            partialLines += lines;
+            recordLatency += minMemoryLatency(record.address);
+            for (uint64_t l = 1; l < lines; l++) {
+                recordLatency += minMemoryLatency(lineBase + l * kTraceLineBytes);
+            }
+        }
+        compute += partialCompute;
+        latency[0] += partialLatency[0];
+        latency[1] += partialLatency[1];
+        accesses += partialLines;
+    });
+
+    if (memoryOps != nullptr) {
+        *memoryOps = accesses;
+    }
+    return combine(compute, latency[0], latency[1]);
+}
+
+uint64_t GraphAnalysis::combine(uint64_t compute, uint64_t loads, uint64_t stores) const {
+    if (computeSpeed != 1.0) {
+        compute = static_cast<uint64_t>(compute / computeSpeed);
+    }
+
+    // A blocking core runs every op back to back
+    if (config.lsqDepth <= 1) {
+        return compute + loads + stores;
+    }
+    uint64_t depth = static_cast<uint64_t>(config.lsqDepth);
+    return std::max(compute + loads / depth, (loads + stores) / depth);
+}
+
+GraphBounds GraphAnalysis::analyze(const TaskGraph& graph) const {
+    const std::vector<Task>& tasks = graph.getTasks();
+    size_t numTasks = tasks.size();
+    // Each hardware thread context runs an instance at a time
+    uint64_t numCores = static_cast<uint64_t>(std::max(config.getContextCount(), 1));
+
+    GraphBounds bounds;
+    bounds.tasks.resize(numTasks);
+
+    // Instance costs: one pass over each task's ops, tasks split across workers
+    parallelFor(numTasks, 64, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            const Task& task = tasks[t];
+            bounds.tasks[t].taskId = task.id;
+            bounds.tasks[t].cost = instanceCost(OpSpan(graph.opData() + task.opBegin, task.opCount),
+                                                &bounds.tasks[t].memoryOps);
+        }
+    });
+
+    // Traces are scanned once each (tasks may share one); each scan is parallel
+    std::map<const TraceFile*, std::pair<uint64_t, uint64_t>> traceCosts;
+    for (size_t t = 0; t < numTasks; t++) {
+        const TraceFile* trace = graph.getTrace(tasks[t].id);
+        if (trace != nullptr) {
+            auto it = traceCosts.find(trace);
+            if (it == traceCosts.end()) {
+                uint64_t lines = 0;
+                uint64_t cost = traceCost(*trace, &lines);
+                it = traceCosts.emplace(trace, std::make_pair(cost, lines)).first;
+            }
+            bounds.tasks[t].cost = it->second.first;
+            bounds.tasks[t].memoryOps = it->second.second;
+        }
+    }
+
+    // Rounds needed to run all executions on numCores cores
+    std::vector<uint64_t> weight(numTasks);
+    for (size_t t = 0; t < numTasks; t++) {
+        uint64_t executions = static_cast<uint64_t>(std::max(tasks[t].executions, 0));
+        weight[t] = (executions + numCores - 1) / numCores * bounds.tasks[t].cost;
+    }
+
+    // Tasks within a topological level do not depend on each other
+    const std::vector<int32_t>& order = graph.getTopologicalOrder();
+    const std::vector<size_t>& levelOffsets = graph.getLevelOffsets();
+    size_t numLevels = levelOffsets.size() - 1;
+
+    // Forward pass: earliest start from the longest predecessor chain
+    for (size_t l = 0; l < numLevels; l++) {
+        const int32_t* level = order.data() + levelOffsets[l];
+        parallelFor(levelOffsets[l + 1] - levelOffsets[l], 1024, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                int32_t t = level[i];
+                uint64_t start = 0;
+                for (int32_t d : graph.getTaskPredecessors(t)) {
+                    start = std::max(start, bounds.tasks[d].earliestStart + weight[d]);
+                }
+                bounds.tasks[t].earliestStart = start;
+            }
+        });
+    }
+
+    // Backward pass: upward rank from the longest successor chain
+    for (size_t l = numLevels; l-- > 0; ) {
+        const int32_t* level = order.data() + levelOffsets[l];
+        parallelFor(levelOffsets[l + 1] - levelOffsets[l], 1024, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                int32_t t = level[i];
+                uint64_t tail = 0;
+                uint64_t instanceTail = 0;
+                for (int32_t s : graph.getTaskSuccessors(t)) {
+                    tail = std::max(tail, bounds.tasks[s].upwardRank);
+                    instanceTail = std::max(instanceTail, bounds.tasks[s].instanceRank);
+                }
+                bounds.tasks[t].upwardRank = weight[t] + tail;
+                bounds.tasks[t].instanceRank = bounds.tasks[t].cost + instanceTail;
+            }
+        });
+    }
+
+    for (size_t t = 0; t < numTasks; t++) {
+        const TaskBound& tb = bounds.tasks[t];
+        bounds.criticalPath = std::max(bounds.criticalPath, tb.earliestStart + tb.upwardRank);
+        bounds.totalWork += static_cast<uint64_t>(std::max(tasks[t].executions, 0)) * tb.cost;
+    }
+    for (auto& tb : bounds.tasks) {
+        tb.slack = bounds.criticalPath - (tb.earliestStart + tb.upwardRank);
+    }
+
+    bounds.workBound = (bounds.totalWork + numCores - 1) / numCores;
+    bounds.lowerBound = std::max(bounds.criticalPath, bounds.workBound);
+    return bounds;
+}
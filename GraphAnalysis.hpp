@@ -0,0 +1,80 @@
+#ifndef GRAPHANALYSIS_HPP
+#define GRAPHANALYSIS_HPP
+
+#include "Types.hpp"
+#include "Config.hpp"
+#include "TaskGraph.hpp"
+#include <cstdint>
+
+/**
+ * GraphAnalysis class
+ * Computes makespan lower bounds from the task graph and configuration
+ * without simulating.
+ *
+ * An instance costs at least the sum of its compute cycles plus, for each
+ * memory op, the fastest tier the op can hit (repeat blocks multiply by their
+ * trip counts). A trace-bound task costs the sum of its gaps plus the fastest
+ * tier of every line its records touch. All instances of a task wait for all
+ * instances of its predecessor tasks, and numCores cores (times their thread
+ * contexts) need ceil(executions / numCores) rounds for one task, so a task contributes that
+ * many instance costs to any dependency chain through it.
+ *
+ * With a load/store queue deeper than one entry, memory ops overlap: at
+ * most lsqDepth are in flight, and loads never overlap compute (compute
+ * waits for them and the core issues nothing while it computes). An
+ * instance then costs at least its compute plus its load latency over the
+ * depth, and at least its total memory latency over the depth.
+ *
+ * The instance rank counts one instance per task instead, the HEFT upward
+ * rank used to prioritize ready instances under the critical_path policy.
+ *
+ * With core classes, compute cycles are divided by the fastest class's speed
+ * and the whole DTCM counts, which bounds every core. Analyzing for one
+ * class instead gives instance costs on a core of that class, as the eft
+ * policy compares them.
+ */
+class GraphAnalysis {
+public:
+    /**
+     * @param config Simulator configuration
+     * @param coreClass Index into config.coreClasses to cost instances on, or -1 for all cores
+     */
+    explicit GraphAnalysis(const Config& config, int coreClass = -1);
+
+    /**
+     * Compute per-task costs, critical path, work bound and slack
+     * @param graph Loaded task graph (buildDAG is not required)
+     * @return Bounds in cycles
+     */
+    GraphBounds analyze(const TaskGraph& graph) const;
+
+    /**
+     * Lower bound on the latency of one memory op
+     * @param op Memory op; literal addresses are classified by DTCM range
+     * @return Cycles of the fastest tier the op can be served from
+     */
+    uint64_t minMemoryLatency(const Op& op) const;
+
+    // Lower bound on the latency of an access to a known address
+    uint64_t minMemoryLatency(uint64_t address) const;
+
+    // Lower bound on one instance's duration for the given op program;
+    // memoryOps, if given, receives the number of memory ops it executes
+    uint64_t instanceCost(OpSpan ops, uint64_t* memoryOps = nullptr) const;
+
+    // Lower bound on one replay of a trace: its gaps plus one access per line;
+    // memoryOps, if given, receives the number of lines
+    uint64_t traceCost(const TraceFile& trace, uint64_t* memoryOps = nullptr) const;
+
+private:
+    const Config& config;
+
+    // Instance bound from compute cycles and the summed load and store latencies
+    uint64_t combine(uint64_t compute, uint64_t loads, uint64_t stores) const;
+
+    uint64_t offChipLatency;  // Fastest path outside DTCM (cache hit or local bank)
+    double computeSpeed;      // Divisor of compute cycles
+    uint64_t dtcmSize;        // DTCM bytes reachable from the DTCM base
+};
+
+#endif // GRAPHANALYSIS_HPP
@@ -0,0 +1,57 @@
+#ifndef GRAPHFILE_HPP
+#define GRAPHFILE_HPP
+
+#include <cstdint>
+
+// Binary task graph format written by csv2graph and mapped by TaskGraph.
+//
+// Layout: header, then 8-byte aligned sections at the offsets it records:
+//   tasks    GraphFileTask[taskCount]
+//   deps     int32_t[depCount]        dependency task ids, referenced per task
+//   ops      Op[opCount]              op arena, used in place
+//   exprs    ExprInstr[exprCount]     compiled address expressions, used in place
+//   strings  char[stringBytes]        task names and core classes, not NUL-terminated
+//
+// Records use the host's native layout; the header carries a byte-order mark
+// and record sizes so a file from an incompatible build is rejected.
+
+constexpr char kGraphFileMagic[8] = {'M', 'C', 'S', 'G', 'R', 'A', 'P', 'H'};
+constexpr uint32_t kGraphFileVersion = 3;
+constexpr uint32_t kGraphFileByteOrderMark = 0x01020304;
+
+struct GraphFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t opRecordSize;      // sizeof(Op) of the writer
+    uint32_t exprRecordSize;    // sizeof(ExprInstr) of the writer
+    uint64_t fileSize;
+    
+    uint64_t taskCount;
+    uint64_t depCount;
+    uint64_t opCount;
+    uint64_t exprCount;
+    uint64_t stringBytes;
+    
+    uint64_t taskOffset;
+    uint64_t depOffset;
+    uint64_t opOffset;
+    uint64_t exprOffset;
+    uint64_t stringOffset;
+};
+
+struct GraphFileTask {
+    int32_t id;
+    int32_t executions;
+    uint64_t nameOffset;        // Into the string table
+    uint32_t nameLength;
+    uint32_t depCount;
+    uint64_t depBegin;          // Index of the first dependency in the deps section
+    uint64_t opBegin;           // Index of the first op in the op arena
+    uint64_t opCount;
+    uint64_t deadline;          // Relative deadline in cycles, 0 for none (version 2)
+    uint64_t coreClassOffset;   // Preferred core class name in the string table (version 3)
+    uint32_t coreClassLength;   // 0 for none
+};
+
+#endif // GRAPHFILE_HPP
@@ -0,0 +1,180 @@
+#ifndef IDLECORESET_HPP
+#define IDLECORESET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * IdleCoreSet class
+ * Idle flags of all cores as a bitmap of 64-bit words, plus one bitmap per
+ * chiplet. Searches skip whole words of busy cores and pick the lowest set
+ * bit with count-trailing-zeros, so finding an idle core costs O(cores / 64)
+ * word tests instead of one test per core.
+ */
+class IdleCoreSet {
+public:
+    /**
+     * Start with every core idle
+     * @param numCores Number of cores
+     * @param coreChiplet Chiplet of each core; empty puts all cores on chiplet 0
+     */
+    explicit IdleCoreSet(int numCores, const std::vector<int>& coreChiplet = {})
+        : numCores(numCores), numWords((static_cast<size_t>(numCores) + 63) / 64),
+          idle(numWords, 0), numChiplets(1), idleCount(0) {
+        for (int chiplet : coreChiplet) {
+            numChiplets = chiplet + 1 > numChiplets ? chiplet + 1 : numChiplets;
+        }
+        chipletIdle.assign(static_cast<size_t>(numChiplets) * numWords, 0);
+        chipletOf.assign(numCores, 0);
+        for (int core = 0; core < numCores && core < static_cast<int>(coreChiplet.size()); core++) {
+            chipletOf[core] = coreChiplet[core];
+        }
+        for (int core = 0; core < numCores; core++) {
+            insert(core);
+        }
+    }
+
+    int size() const { return numCores; }
+    int count() const { return idleCount; }
+    bool empty() const { return idleCount == 0; }
+    int chipletCount() const { return numChiplets; }
+
+    bool contains(int core) const {
+        return (idle[core >> 6] >> (core & 63)) & 1;
+    }
+
+    void insert(int core) {
+        uint64_t bit = uint64_t(1) << (core & 63);
+        if (!(idle[core >> 6] & bit)) {
+            idle[core >> 6] |= bit;
+            chipletWords(chipletOf[core])[core >> 6] |= bit;
+            idleCount++;
+        }
+    }
+
+    void erase(int core) {
+        uint64_t bit = uint64_t(1) << (core & 63);
+        if (idle[core >> 6] & bit) {
+            idle[core >> 6] &= ~bit;
+            chipletWords(chipletOf[core])[core >> 6] &= ~bit;
+            idleCount--;
+        }
+    }
+
+    // First idle core at or after start, wrapping around; -1 if none
+    int next(int start) const {
+        return search(idle.data(), start);
+    }
+
+    // Same as next() restricted to one chiplet
+    int nextInChiplet(int chiplet, int start) const {
+        if (chiplet < 0 || chiplet >= chipletCount()) {
+            return -1;
+        }
+        return search(chipletIdle.data() + static_cast<size_t>(chiplet) * numWords, start);
+    }
+
+    // The idle core of rank k in core order, 0 <= k < count(); -1 if none
+    int nth(int k) const {
+        return select(idle.data(), k);
+    }
+
+    // Same as nth() restricted to one chiplet, 0 <= k < countInChiplet(chiplet)
+    int nthInChiplet(int chiplet, int k) const {
+        if (chiplet < 0 || chiplet >= chipletCount()) {
+            return -1;
+        }
+        return select(chipletIdle.data() + static_cast<size_t>(chiplet) * numWords, k);
+    }
+
+    // Idle cores of one chiplet
+    int countInChiplet(int chiplet) const {
+        if (chiplet < 0 || chiplet >= chipletCount()) {
+            return 0;
+        }
+        const uint64_t* words = chipletIdle.data() + static_cast<size_t>(chiplet) * numWords;
+        int total = 0;
+        for (size_t w = 0; w < numWords; w++) {
+            total += popCount(words[w]);
+        }
+        return total;
+    }
+
+private:
+    int numCores;
+    size_t numWords;
+    std::vector<uint64_t> idle;         // Bit c of word c / 64 set when core c is idle
+    std::vector<uint64_t> chipletIdle;  // numWords words per chiplet, same layout
+    std::vector<int> chipletOf;
+    int numChiplets;
+    int idleCount;
+
+    static int lowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    static int popCount(uint64_t bits) {
+#ifdef _MSC_VER
+        return static_cast<int>(__popcnt64(bits));
+#else
+        return __builtin_popcountll(bits);
+#endif
+    }
+
+    uint64_t* chipletWords(int chiplet) {
+        return chipletIdle.data() + static_cast<size_t>(chiplet) * numWords;
+    }
+
+    int select(const uint64_t* words, int k) const {
+        // Skip whole words by their population, then drop the k lowest set
+        // bits of the word holding the answer
+        for (size_t w = 0; w < numWords && k >= 0; w++) {
+            int inWord = popCount(words[w]);
+            if (k < inWord) {
+                uint64_t bits = words[w];
+                for (; k > 0; k--) {
+                    bits &= bits - 1;
+                }
+                return static_cast<int>(w * 64) + lowestBit(bits);
+            }
+            k -= inWord;
+        }
+        return -1;
+    }
+
+    int search(const uint64_t* words, int start) const {
+        if (numCores == 0) {
+            return -1;
+        }
+        int from = start % numCores;
+        size_t first = static_cast<size_t>(from) >> 6;
+
+        // Bits at or above start in its own word, then the following words
+        // with wrap-around, and finally the whole first word again for the
+        // bits below start
+        uint64_t bits = words[first] & (~uint64_t(0) << (from & 63));
+        for (size_t step = 0; step <= numWords; step++) {
+            size_t w = (first + step) % numWords;
+            if (step > 0) {
+                bits = words[w];
+            }
+            if (bits != 0) {
+                return static_cast<int>(w * 64) + lowestBit(bits);
+            }
+        }
+        return -1;
+    }
+};
+
+#endif // IDLECORESET_HPP
@@ -0,0 +1,142 @@
+#ifndef INSTANCETABLE_HPP
+#define INSTANCETABLE_HPP
+
+#include "Types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * InstanceTable class
+ * Runtime state of all task instances, stored as parallel arrays indexed by
+ * instance id.
+ *
+ * Hot columns (taskId, opIndex, inDegree) are read or written on every op
+ * step and dependency decrement and are kept dense as int32. Cold columns
+ * (execution index, timestamps, successor lists) are only touched on
+ * dispatch and completion, so they live in separate arrays and do not dilute
+ * the cache lines of the hot path.
+ */
+class InstanceTable {
+public:
+    // Append an instance and return its id
+    int add(int32_t taskId, int32_t executionIndex, int32_t inDegree = 0) {
+        int id = static_cast<int>(taskIds.size());
+        taskIds.push_back(taskId);
+        opIndices.push_back(0);
+        inDegrees.push_back(inDegree);
+        executionIndices.push_back(executionIndex);
+        readyTimes.push_back(0);
+        dispatchTimes.push_back(0);
+        doneTimes.push_back(0);
+        return id;
+    }
+
+    // Reinitialize a recycled slot for a new instance
+    void reset(int id, int32_t taskId, int32_t executionIndex, uint64_t readyTime) {
+        taskIds[id] = taskId;
+        opIndices[id] = 0;
+        inDegrees[id] = 0;
+        executionIndices[id] = executionIndex;
+        readyTimes[id] = readyTime;
+        dispatchTimes[id] = 0;
+        doneTimes[id] = 0;
+    }
+
+    void reserve(size_t count) {
+        taskIds.reserve(count);
+        opIndices.reserve(count);
+        inDegrees.reserve(count);
+        executionIndices.reserve(count);
+        readyTimes.reserve(count);
+        dispatchTimes.reserve(count);
+        doneTimes.reserve(count);
+    }
+
+    /**
+     * Install the instance-level edges
+     * @param offsets size() + 1 prefix offsets into targets
+     * @param targets Successor instance ids of all instances, grouped by source
+     */
+    void assignSuccessors(std::vector<uint64_t>&& offsets, std::vector<int32_t>&& targets) {
+        successorOffsets = std::move(offsets);
+        successorTargets = std::move(targets);
+    }
+
+    void clear() {
+        taskIds.clear();
+        opIndices.clear();
+        inDegrees.clear();
+        executionIndices.clear();
+        readyTimes.clear();
+        dispatchTimes.clear();
+        doneTimes.clear();
+        successorOffsets.clear();
+        successorTargets.clear();
+    }
+
+    size_t size() const { return taskIds.size(); }
+    bool empty() const { return taskIds.empty(); }
+
+    // Hot state
+    int32_t& taskId(int id) { return taskIds[id]; }
+    int32_t taskId(int id) const { return taskIds[id]; }
+    int32_t& opIndex(int id) { return opIndices[id]; }
+    int32_t opIndex(int id) const { return opIndices[id]; }
+    int32_t& inDegree(int id) { return inDegrees[id]; }
+    int32_t inDegree(int id) const { return inDegrees[id]; }
+
+    // Cold state
+    int32_t executionIndex(int id) const { return executionIndices[id]; }
+    uint64_t& readyTime(int id) { return readyTimes[id]; }
+    uint64_t readyTime(int id) const { return readyTimes[id]; }
+    uint64_t& dispatchTime(int id) { return dispatchTimes[id]; }
+    uint64_t dispatchTime(int id) const { return dispatchTimes[id]; }
+    uint64_t& doneTime(int id) { return doneTimes[id]; }
+    uint64_t doneTime(int id) const { return doneTimes[id]; }
+
+    // Successor instance ids (empty for lazily materialized instances)
+    IdSpan successors(int id) const {
+        if (static_cast<size_t>(id) + 1 >= successorOffsets.size()) {
+            return IdSpan();
+        }
+        uint64_t begin = successorOffsets[id];
+        return IdSpan(successorTargets.data() + begin, successorOffsets[id + 1] - begin);
+    }
+
+    size_t edgeCount() const { return successorTargets.size(); }
+
+    // Bytes held by the CSR edge arrays
+    size_t edgeBytes() const {
+        return successorOffsets.size() * sizeof(uint64_t) + successorTargets.size() * sizeof(int32_t);
+    }
+
+    // Estimated bytes the same edges take as one std::vector<int> per instance,
+    // counting a 16-byte allocator header per non-empty vector
+    size_t nestedEdgeBytes() const {
+        size_t bytes = size() * sizeof(std::vector<int>) + edgeCount() * sizeof(int);
+        for (size_t i = 0; i + 1 < successorOffsets.size(); i++) {
+            if (successorOffsets[i + 1] != successorOffsets[i]) {
+                bytes += 16;
+            }
+        }
+        return bytes;
+    }
+
+private:
+    // Hot columns
+    std::vector<int32_t> taskIds;
+    std::vector<int32_t> opIndices;
+    std::vector<int32_t> inDegrees;
+
+    // Cold columns
+    std::vector<int32_t> executionIndices;
+    std::vector<uint64_t> readyTimes;
+    std::vector<uint64_t> dispatchTimes;
+    std::vector<uint64_t> doneTimes;
+    std::vector<uint64_t> successorOffsets;   // CSR row offsets, size() + 1 entries
+    std::vector<int32_t> successorTargets;    // CSR successor instance ids
+};
+
+#endif // INSTANCETABLE_HPP
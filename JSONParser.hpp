@@ -1,20 +1,19 @@
 #ifndef JSONPARSER_HPP
 #define JSONPARSER_HPP
 
-#include <string>
-#include <map>
-#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
 #include <memory>
 #include <stdexcept>
-#include <sstream>
-#include <fstream>
-#include <cctype>
-
-// Forward declaration
-class JSONValue;
+#include <string>
+#include <string_view>
+#include <vector>
 
 // JSON value types
-enum class JSONType {
+enum class JSONType : uint8_t {
     Null,
     Boolean,
     Number,
@@ -23,24 +22,30 @@ enum class JSONType {
     Array
 };
 
-// JSON value class
+// JSON value: a 32-byte node of a JSONDocument, valid while the document
+// lives. Object members and array elements are contiguous runs of child
+// nodes; strings and member keys view the document's text.
 class JSONValue {
 public:
-    JSONType type;
-    
-    // Value storage
-    bool boolValue;
-    double numberValue;
-    std::string stringValue;
-    std::map<std::string, std::shared_ptr<JSONValue>> objectValue;
-    std::vector<std::shared_ptr<JSONValue>> arrayValue;
-    
-    JSONValue() : type(JSONType::Null), boolValue(false), numberValue(0.0) {}
-    
-    explicit JSONValue(bool b) : type(JSONType::Boolean), boolValue(b), numberValue(0.0) {}
-    explicit JSONValue(double n) : type(JSONType::Number), boolValue(false), numberValue(n) {}
-    explicit JSONValue(const std::string& s) : type(JSONType::String), boolValue(false), numberValue(0.0), stringValue(s) {}
-    
+    // Children of an object or array, in document order
+    class Range {
+    public:
+        Range(const JSONValue* first, size_t count) : first(first), count(count) {}
+        const JSONValue* begin() const { return first; }
+        const JSONValue* end() const { return first + count; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const JSONValue& operator[](size_t index) const { return first[index]; }
+
+    private:
+        const JSONValue* first;
+        size_t count;
+    };
+
+    JSONValue() { payload.number = 0.0; }
+
+    JSONType type = JSONType::Null;
+
     // Type checking
     bool isNull() const { return type == JSONType::Null; }
     bool isBool() const { return type == JSONType::Boolean; }
@@ -48,338 +53,460 @@ public:
     bool isString() const { return type == JSONType::String; }
     bool isObject() const { return type == JSONType::Object; }
     bool isArray() const { return type == JSONType::Array; }
-    
+
+    // Member name of an object member, empty otherwise
+    std::string_view key() const { return std::string_view(keyData, keyLength); }
+
     // Getters with type checking
     bool asBool() const {
         if (type != JSONType::Boolean) {
             throw std::runtime_error("JSON value is not a boolean");
         }
-        return boolValue;
+        return payload.boolean;
     }
-    
+
     double asNumber() const {
         if (type != JSONType::Number) {
             throw std::runtime_error("JSON value is not a number");
         }
-        return numberValue;
+        return payload.number;
     }
-    
+
     int asInt() const {
         return static_cast<int>(asNumber());
     }
-    
-    const std::string& asString() const {
+
+    std::string_view asString() const {
         if (type != JSONType::String) {
             throw std::runtime_error("JSON value is not a string");
         }
-        return stringValue;
+        return std::string_view(payload.string.data, payload.string.length);
     }
-    
-    const std::map<std::string, std::shared_ptr<JSONValue>>& asObject() const {
+
+    Range asObject() const {
         if (type != JSONType::Object) {
             throw std::runtime_error("JSON value is not an object");
         }
-        return objectValue;
+        return Range(payload.children.first, payload.children.count);
     }
-    
-    const std::vector<std::shared_ptr<JSONValue>>& asArray() const {
+
+    Range asArray() const {
         if (type != JSONType::Array) {
             throw std::runtime_error("JSON value is not an array");
         }
-        return arrayValue;
+        return Range(payload.children.first, payload.children.count);
+    }
+
+    // Object access; a repeated key resolves to its last occurrence
+    const JSONValue* find(std::string_view member) const {
+        if (type != JSONType::Object) return nullptr;
+        for (size_t i = payload.children.count; i > 0; i--) {
+            const JSONValue& child = payload.children.first[i - 1];
+            if (child.key() == member) {
+                return &child;
+            }
+        }
+        return nullptr;
     }
-    
-    // Object access
-    bool hasKey(const std::string& key) const {
-        if (type != JSONType::Object) return false;
-        return objectValue.find(key) != objectValue.end();
+
+    bool hasKey(std::string_view member) const {
+        return find(member) != nullptr;
     }
-    
-    std::shared_ptr<JSONValue> get(const std::string& key) const {
+
+    const JSONValue* get(std::string_view member) const {
         if (type != JSONType::Object) {
             throw std::runtime_error("JSON value is not an object");
         }
-        auto it = objectValue.find(key);
-        if (it == objectValue.end()) {
-            throw std::runtime_error("JSON object does not have key: " + key);
+        const JSONValue* value = find(member);
+        if (value == nullptr) {
+            throw std::runtime_error("JSON object does not have key: " + std::string(member));
         }
-        return it->second;
+        return value;
     }
-    
+
     // Hex string conversion for addresses
     uint64_t asHexAddress() const {
-        const std::string& str = asString();
-        uint64_t addr;
-        std::stringstream ss;
-        
+        std::string_view str = asString();
+
         // Handle "0x" prefix
         if (str.length() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
-            ss << std::hex << str.substr(2);
-        } else {
-            ss << std::hex << str;
+            str.remove_prefix(2);
         }
-        
-        ss >> addr;
-        if (ss.fail()) {
-            throw std::runtime_error("Failed to parse hex address: " + str);
+
+        uint64_t addr = 0;
+        auto result = std::from_chars(str.data(), str.data() + str.size(), addr, 16);
+        if (result.ec != std::errc() || result.ptr == str.data()) {
+            throw std::runtime_error("Failed to parse hex address: " + std::string(asString()));
         }
-        
+
         return addr;
     }
+
+private:
+    friend class JSONDocument;
+
+    struct StringRef {
+        const char* data;
+        uint32_t length;
+    };
+    struct ChildRef {
+        const JSONValue* first;
+        uint32_t count;
+    };
+
+    uint32_t keyLength = 0;             // Packs next to type
+    const char* keyData = nullptr;
+    union {
+        double number;
+        bool boolean;
+        StringRef string;
+        ChildRef children;
+    } payload;
 };
 
-// JSON Parser class
-class JSONParser {
+static_assert(sizeof(JSONValue) == 32, "JSONValue is sized to pack two nodes per cache line");
+
+/**
+ * JSONDocument class
+ * Owns the text of a parsed document and all of its nodes. Nodes are carved
+ * from large arena blocks, each container's children as one contiguous run,
+ * and strings are unescaped in place in the text, so parsing allocates a few
+ * blocks rather than one per value, key and string.
+ */
+class JSONDocument {
 public:
-    static std::shared_ptr<JSONValue> parseFile(const std::string& filepath) {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
-            throw std::runtime_error("Failed to open JSON file: " + filepath);
-        }
-        
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        file.close();
-        
-        std::string content = buffer.str();
+    explicit JSONDocument(std::string text) : source(std::move(text)) {
         size_t pos = 0;
-        return parseValue(content, pos);
-    }
-    
-    static std::shared_ptr<JSONValue> parseString(const std::string& jsonStr) {
-        size_t pos = 0;
-        return parseValue(jsonStr, pos);
+        root = parseValue(pos);
+        skipWhitespace(pos);
+        if (pos < source.size()) {
+            throw std::runtime_error("Unexpected trailing characters in JSON");
+        }
+        pending = std::vector<JSONValue>();
     }
 
+    // Nodes point into the document, so it stays where it was built
+    JSONDocument(const JSONDocument&) = delete;
+    JSONDocument& operator=(const JSONDocument&) = delete;
+
+    const JSONValue& value() const { return root; }
+    const JSONValue* operator->() const { return &root; }
+    const JSONValue& operator*() const { return root; }
+
+    // Number of nodes below the root
+    size_t nodeCount() const { return nodes; }
+
 private:
-    static void skipWhitespace(const std::string& str, size_t& pos) {
-        while (pos < str.length() && std::isspace(static_cast<unsigned char>(str[pos]))) {
+    static constexpr size_t kBlockNodes = 8192;
+
+    std::string source;
+    std::vector<std::unique_ptr<JSONValue[]>> blocks;   // Node arena
+    size_t blockUsed = 0;
+    size_t blockSize = 0;
+    size_t nodes = 0;
+    std::vector<JSONValue> pending;     // Children of the containers being parsed
+    JSONValue root;
+
+    // Place the children parsed since mark in the arena as one run
+    void closeContainer(size_t mark, JSONValue& container) {
+        size_t count = pending.size() - mark;
+        if (count > UINT32_MAX) {
+            throw std::runtime_error("JSON container has too many elements");
+        }
+        if (count == 0) {
+            container.payload.children = {nullptr, 0};
+            return;
+        }
+        if (blockSize - blockUsed < count) {
+            blockSize = count > kBlockNodes ? count : kBlockNodes;
+            blocks.emplace_back(new JSONValue[blockSize]);
+            blockUsed = 0;
+        }
+        JSONValue* run = blocks.back().get() + blockUsed;
+        std::copy(pending.begin() + mark, pending.end(), run);
+        blockUsed += count;
+        nodes += count;
+        pending.resize(mark);
+
+        container.payload.children.first = run;
+        container.payload.children.count = static_cast<uint32_t>(count);
+    }
+
+    static uint32_t checkedLength(size_t length) {
+        if (length > UINT32_MAX) {
+            throw std::runtime_error("JSON string too long");
+        }
+        return static_cast<uint32_t>(length);
+    }
+
+    void skipWhitespace(size_t& pos) const {
+        while (pos < source.size()) {
+            char c = source[pos];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+                break;
+            }
             pos++;
         }
     }
-    
-    static std::shared_ptr<JSONValue> parseValue(const std::string& str, size_t& pos) {
-        skipWhitespace(str, pos);
-        
-        if (pos >= str.length()) {
+
+    JSONValue parseValue(size_t& pos) {
+        skipWhitespace(pos);
+
+        if (pos >= source.size()) {
             throw std::runtime_error("Unexpected end of JSON input");
         }
-        
-        char c = str[pos];
-        
+
+        char c = source[pos];
+        JSONValue value;
+
         if (c == '{') {
-            return parseObject(str, pos);
+            parseObject(pos, value);
         } else if (c == '[') {
-            return parseArray(str, pos);
+            parseArray(pos, value);
         } else if (c == '"') {
-            return parseStringValue(str, pos);
+            std::string_view text = parseString(pos);
+            value.type = JSONType::String;
+            value.payload.string = {text.data(), checkedLength(text.size())};
         } else if (c == 't' || c == 'f') {
-            return parseBool(str, pos);
+            parseBool(pos, value);
         } else if (c == 'n') {
-            return parseNull(str, pos);
-        } else if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
-            return parseNumber(str, pos);
+            parseNull(pos);
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            parseNumber(pos, value);
         } else {
             throw std::runtime_error("Unexpected character in JSON: " + std::string(1, c));
         }
+        return value;
     }
-    
-    static std::shared_ptr<JSONValue> parseObject(const std::string& str, size_t& pos) {
-        auto obj = std::make_shared<JSONValue>();
-        obj->type = JSONType::Object;
-        
+
+    void parseObject(size_t& pos, JSONValue& obj) {
+        obj.type = JSONType::Object;
+        size_t mark = pending.size();
+
         pos++; // Skip '{'
-        skipWhitespace(str, pos);
-        
-        if (pos < str.length() && str[pos] == '}') {
+        skipWhitespace(pos);
+
+        if (pos < source.size() && source[pos] == '}') {
             pos++; // Empty object
-            return obj;
+            closeContainer(mark, obj);
+            return;
         }
-        
-        while (pos < str.length()) {
-            skipWhitespace(str, pos);
-            
+
+        while (true) {
+            skipWhitespace(pos);
+
             // Parse key
-            if (pos >= str.length() || str[pos] != '"') {
+            if (pos >= source.size() || source[pos] != '"') {
                 throw std::runtime_error("Expected string key in JSON object");
             }
-            
-            auto keyValue = parseStringValue(str, pos);
-            std::string key = keyValue->asString();
-            
-            skipWhitespace(str, pos);
-            
+            std::string_view key = parseString(pos);
+
+            skipWhitespace(pos);
+
             // Expect ':'
-            if (pos >= str.length() || str[pos] != ':') {
+            if (pos >= source.size() || source[pos] != ':') {
                 throw std::runtime_error("Expected ':' after key in JSON object");
             }
             pos++;
-            
+
             // Parse value
-            auto value = parseValue(str, pos);
-            obj->objectValue[key] = value;
-            
-            skipWhitespace(str, pos);
-            
-            if (pos >= str.length()) {
+            JSONValue value = parseValue(pos);
+            value.keyData = key.data();
+            value.keyLength = checkedLength(key.size());
+            pending.push_back(value);
+
+            skipWhitespace(pos);
+
+            if (pos >= source.size()) {
                 throw std::runtime_error("Unexpected end of JSON object");
             }
-            
-            if (str[pos] == '}') {
+
+            if (source[pos] == '}') {
                 pos++;
                 break;
-            } else if (str[pos] == ',') {
+            } else if (source[pos] == ',') {
                 pos++;
             } else {
                 throw std::runtime_error("Expected ',' or '}' in JSON object");
             }
         }
-        
-        return obj;
+
+        closeContainer(mark, obj);
     }
-    
-    static std::shared_ptr<JSONValue> parseArray(const std::string& str, size_t& pos) {
-        auto arr = std::make_shared<JSONValue>();
-        arr->type = JSONType::Array;
-        
+
+    void parseArray(size_t& pos, JSONValue& arr) {
+        arr.type = JSONType::Array;
+        size_t mark = pending.size();
+
         pos++; // Skip '['
-        skipWhitespace(str, pos);
-        
-        if (pos < str.length() && str[pos] == ']') {
+        skipWhitespace(pos);
+
+        if (pos < source.size() && source[pos] == ']') {
             pos++; // Empty array
-            return arr;
-        }
-        
-        while (pos < str.length()) {
-            auto value = parseValue(str, pos);
-            arr->arrayValue.push_back(value);
-            
-            skipWhitespace(str, pos);
-            
-            if (pos >= str.length()) {
+            closeContainer(mark, arr);
+            return;
+        }
+
+        while (true) {
+            pending.push_back(parseValue(pos));
+
+            skipWhitespace(pos);
+
+            if (pos >= source.size()) {
                 throw std::runtime_error("Unexpected end of JSON array");
             }
-            
-            if (str[pos] == ']') {
+
+            if (source[pos] == ']') {
                 pos++;
                 break;
-            } else if (str[pos] == ',') {
+            } else if (source[pos] == ',') {
                 pos++;
             } else {
                 throw std::runtime_error("Expected ',' or ']' in JSON array");
             }
         }
-        
-        return arr;
+
+        closeContainer(mark, arr);
     }
-    
-    static std::shared_ptr<JSONValue> parseStringValue(const std::string& str, size_t& pos) {
+
+    // Unescaping never lengthens a string, so the result is written over
+    // the escaped text and returned as a view of it
+    std::string_view parseString(size_t& pos) {
         pos++; // Skip opening '"'
-        std::string result;
-        
-        while (pos < str.length()) {
-            char c = str[pos];
-            
+        size_t start = pos;
+        size_t out = pos;
+
+        while (pos < source.size()) {
+            char c = source[pos];
+
             if (c == '"') {
                 pos++; // Skip closing '"'
-                return std::make_shared<JSONValue>(result);
+                return std::string_view(source.data() + start, out - start);
             } else if (c == '\\') {
                 pos++;
-                if (pos >= str.length()) {
+                if (pos >= source.size()) {
                     throw std::runtime_error("Unexpected end of string escape sequence");
                 }
-                
-                char escaped = str[pos];
+
+                char escaped = source[pos];
                 switch (escaped) {
-                    case '"': result += '"'; break;
-                    case '\\': result += '\\'; break;
-                    case '/': result += '/'; break;
-                    case 'b': result += '\b'; break;
-                    case 'f': result += '\f'; break;
-                    case 'n': result += '\n'; break;
-                    case 'r': result += '\r'; break;
-                    case 't': result += '\t'; break;
+                    case '"': source[out++] = '"'; break;
+                    case '\\': source[out++] = '\\'; break;
+                    case '/': source[out++] = '/'; break;
+                    case 'b': source[out++] = '\b'; break;
+                    case 'f': source[out++] = '\f'; break;
+                    case 'n': source[out++] = '\n'; break;
+                    case 'r': source[out++] = '\r'; break;
+                    case 't': source[out++] = '\t'; break;
                     default:
                         throw std::runtime_error("Invalid escape sequence in string");
                 }
                 pos++;
             } else {
-                result += c;
+                source[out++] = c;
                 pos++;
             }
         }
-        
+
         throw std::runtime_error("Unterminated string in JSON");
     }
-    
-    static std::shared_ptr<JSONValue> parseNumber(const std::string& str, size_t& pos) {
+
+    void parseNumber(size_t& pos, JSONValue& value) {
         size_t start = pos;
-        
+        auto isDigit = [this](size_t at) { return at < source.size() && source[at] >= '0' && source[at] <= '9'; };
+
         // Optional minus
-        if (pos < str.length() && str[pos] == '-') {
+        if (pos < source.size() && source[pos] == '-') {
             pos++;
         }
-        
+
         // Integer part
-        if (pos >= str.length() || !std::isdigit(static_cast<unsigned char>(str[pos]))) {
+        if (!isDigit(pos)) {
             throw std::runtime_error("Invalid number in JSON");
         }
-        
-        while (pos < str.length() && std::isdigit(static_cast<unsigned char>(str[pos]))) {
+
+        while (isDigit(pos)) {
             pos++;
         }
-        
+
         // Optional decimal part
-        if (pos < str.length() && str[pos] == '.') {
+        if (pos < source.size() && source[pos] == '.') {
             pos++;
-            if (pos >= str.length() || !std::isdigit(static_cast<unsigned char>(str[pos]))) {
+            if (!isDigit(pos)) {
                 throw std::runtime_error("Invalid number in JSON");
             }
-            while (pos < str.length() && std::isdigit(static_cast<unsigned char>(str[pos]))) {
+            while (isDigit(pos)) {
                 pos++;
             }
         }
-        
+
         // Optional exponent
-        if (pos < str.length() && (str[pos] == 'e' || str[pos] == 'E')) {
+        if (pos < source.size() && (source[pos] == 'e' || source[pos] == 'E')) {
             pos++;
-            if (pos < str.length() && (str[pos] == '+' || str[pos] == '-')) {
+            if (pos < source.size() && (source[pos] == '+' || source[pos] == '-')) {
                 pos++;
             }
-            if (pos >= str.length() || !std::isdigit(static_cast<unsigned char>(str[pos]))) {
+            if (!isDigit(pos)) {
                 throw std::runtime_error("Invalid number in JSON");
             }
-            while (pos < str.length() && std::isdigit(static_cast<unsigned char>(str[pos]))) {
+            while (isDigit(pos)) {
                 pos++;
             }
         }
-        
-        std::string numStr = str.substr(start, pos - start);
-        double value = std::stod(numStr);
-        
-        return std::make_shared<JSONValue>(value);
+
+        value.type = JSONType::Number;
+        auto result = std::from_chars(source.data() + start, source.data() + pos, value.payload.number);
+        if (result.ec != std::errc()) {
+            throw std::runtime_error("Number out of range in JSON");
+        }
     }
-    
-    static std::shared_ptr<JSONValue> parseBool(const std::string& str, size_t& pos) {
-        if (str.substr(pos, 4) == "true") {
+
+    void parseBool(size_t& pos, JSONValue& value) {
+        std::string_view rest = std::string_view(source).substr(pos);
+        value.type = JSONType::Boolean;
+        if (rest.substr(0, 4) == "true") {
             pos += 4;
-            return std::make_shared<JSONValue>(true);
-        } else if (str.substr(pos, 5) == "false") {
+            value.payload.boolean = true;
+        } else if (rest.substr(0, 5) == "false") {
             pos += 5;
-            return std::make_shared<JSONValue>(false);
+            value.payload.boolean = false;
         } else {
             throw std::runtime_error("Invalid boolean value in JSON");
         }
     }
-    
-    static std::shared_ptr<JSONValue> parseNull(const std::string& str, size_t& pos) {
-        if (str.substr(pos, 4) == "null") {
+
+    void parseNull(size_t& pos) {
+        if (std::string_view(source).substr(pos, 4) == "null") {
             pos += 4;
-            return std::make_shared<JSONValue>();
         } else {
             throw std::runtime_error("Invalid null value in JSON");
         }
     }
 };
 
+// JSON Parser class
+class JSONParser {
+public:
+    static JSONDocument parseFile(const std::string& filepath) {
+        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open JSON file: " + filepath);
+        }
+
+        // One read into a buffer of the file's size
+        std::string content(static_cast<size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        file.read(&content[0], static_cast<std::streamsize>(content.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to read JSON file: " + filepath);
+        }
+
+        return JSONDocument(std::move(content));
+    }
+
+    static JSONDocument parseString(std::string jsonStr) {
+        return JSONDocument(std::move(jsonStr));
+    }
+};
+
 #endif // JSONPARSER_HPP
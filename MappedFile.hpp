@@ -0,0 +1,39 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * MappedFile class
+ * Read-only memory mapping of an input file. Falls back to reading the whole
+ * file into memory on platforms without mmap.
+ */
+class MappedFile {
+public:
+    /**
+     * Map a file for reading
+     * @param path File to map
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+    const std::string& path() const { return filePath; }
+    
+    // Hint that the mapping will be read front to back (read-ahead, early reclaim)
+    void adviseSequential() const;
+    
+private:
+    std::string filePath;
+    const char* bytes;
+    size_t length;
+    std::vector<char> buffer;  // Used instead of a mapping on platforms without mmap
+};
+
+#endif // MAPPEDFILE_HPP
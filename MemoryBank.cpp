@@ -62,6 +62,10 @@ void MemoryBank::receiveRequest(uint64_t address, AccessType rw, int coreId,
     requestCount++;
 }
 
+void MemoryBank::recordRequest() {
+    requestCount++;
+}
+
 uint64_t MemoryBank::serviceRequest(uint64_t currentTime) {
     // Check if there are any requests to service
     if (requestQueue.empty()) {
@@ -112,6 +112,11 @@ public:
      */
     uint64_t serviceRequest(uint64_t currentTime);
     
+    /**
+     * Count a request whose latency the caller computes itself (not queued)
+     */
+    void recordRequest();
+    
     /**
      * Check if there are queued requests
      * @return true if queue is not empty
@@ -1,8 +1,10 @@
 #include "MemorySystem.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 MemorySystem::MemorySystem(const Config& cfg) 
-    : config(cfg), eventScheduler(nullptr), schedulerContext(nullptr) {
+    : config(cfg), eventScheduler(nullptr), schedulerContext(nullptr),
+      localBankAccesses(0), remoteBankAccesses(0), trackOccupancy(false), peakBankRequestsInFlight(0) {
     
     // Initialize DTCM if enabled
     if (config.dtcmEnabled) {
@@ -15,6 +17,11 @@ MemorySystem::MemorySystem(const Config& cfg)
             config.dtcmLatency,
             0  // Core 0
         );
+        if (!config.coreClasses.empty()) {
+            for (int c = 0; c < config.getContextCount(); c++) {
+                contextDtcmSize.push_back(config.getCoreClass(config.getContextCore(c))->dtcmSize);
+            }
+        }
     }
     
     // Initialize Cache if enabled
@@ -94,8 +101,10 @@ MainMemory* MemorySystem::getMainMemory() const {
 }
 
 void MemorySystem::routeRequest(const MemoryRequest& req, uint64_t currentTime) {
-    // Check DTCM range first (highest priority, lowest latency)
-    if (dtcm && dtcm->inRange(req.address)) {
+    // Check DTCM range first (highest priority, lowest latency); a core
+    // class with a smaller DTCM goes past it for the rest of the range
+    if (dtcm && dtcm->inRange(req.address) &&
+        (contextDtcmSize.empty() || req.address - config.dtcmBase < contextDtcmSize[req.coreId])) {
         handleDTCMAccess(req, currentTime);
         return;
     }
@@ -142,28 +151,69 @@ void MemorySystem::handleBankAccess(const MemoryRequest& req, uint64_t currentTi
                                           config.bankIndexFn);
     
     // Get source and destination chiplets for interconnect latency calculation
-    int srcChiplet = config.getCoreChiplet(req.coreId);
+    int srcChiplet = config.getCoreChiplet(config.getContextCore(req.coreId));
     int dstChiplet = banks[bankId].getChipletId();
     
     // Calculate interconnect latency
     int interconnectLatency = interconnect->calculateLatency(srcChiplet, dstChiplet, 64);
+    if (srcChiplet == dstChiplet) {
+        localBankAccesses++;
+    } else {
+        remoteBankAccesses++;
+    }
     
-    // Enqueue request to interconnect
-    interconnect->enqueue(req.address, req.rw, req.coreId, req.taskInstanceId,
-                         currentTime, srcChiplet, dstChiplet, 64);
-    
-    // Forward request to the appropriate bank
-    banks[bankId].receiveRequest(req.address, req.rw, req.coreId, 
-                                 req.taskInstanceId, currentTime, srcChiplet);
+    // Latency is closed-form, so the request is only counted: nothing drains
+    // the interconnect and bank queues, and queuing every access would grow
+    // memory with the length of the run
+    banks[bankId].recordRequest();
     
     // Calculate total latency: interconnect + bank service
     int bankLatency = banks[bankId].getServiceLatency();
     int totalLatency = interconnectLatency + bankLatency;
     
+    if (trackOccupancy) {
+        getBankRequestsInFlight(currentTime);  // Drops answered requests
+        bankCompletions.push_back(currentTime + totalLatency);
+        std::push_heap(bankCompletions.begin(), bankCompletions.end(), std::greater<uint64_t>());
+        peakBankRequestsInFlight = std::max(peakBankRequestsInFlight, bankCompletions.size());
+    }
+    
     // Complete the request with total latency
     completeRequest(req, currentTime, totalLatency);
 }
 
+void MemorySystem::setOccupancyTracking(bool enabled) {
+    trackOccupancy = enabled;
+    bankCompletions.clear();
+    peakBankRequestsInFlight = 0;
+}
+
+size_t MemorySystem::getBankRequestsInFlight(uint64_t currentTime) {
+    while (!bankCompletions.empty() && bankCompletions.front() <= currentTime) {
+        std::pop_heap(bankCompletions.begin(), bankCompletions.end(), std::greater<uint64_t>());
+        bankCompletions.pop_back();
+    }
+    return bankCompletions.size();
+}
+
+uint64_t MemorySystem::getBankRequestDoneTime(size_t n) const {
+    if (n == 0 || n > bankCompletions.size()) {
+        throw std::out_of_range("Fewer bank requests in flight than requested");
+    }
+    // At most one load/store queue of requests per thread context is in flight, so a copy is cheap
+    std::vector<uint64_t> times(bankCompletions);
+    std::nth_element(times.begin(), times.begin() + (n - 1), times.end());
+    return times[n - 1];
+}
+
+int MemorySystem::getBankPortCount() const {
+    int portsPerBank = 1;
+    if (config.bankConflictPolicy == BankConflictPolicy::Queue && config.bankPortLimit > 0) {
+        portsPerBank = config.bankPortLimit;
+    }
+    return config.numMemoryBanks * portsPerBank;
+}
+
 void MemorySystem::completeRequest(const MemoryRequest& req, uint64_t currentTime,
                                    int additionalLatency) {
     // Calculate completion time
@@ -176,7 +226,7 @@ void MemorySystem::completeRequest(const MemoryRequest& req, uint64_t currentTim
         req.coreId,
         req.taskInstanceId,
         req.address,
-        0  // context field
+        static_cast<int>(req.rw)  // The core retires a load or a store
     );
     
     // Schedule the event through the callback if available
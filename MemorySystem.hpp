@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <vector>
 #include <memory>
+#include <functional>
 #include "Types.hpp"
 #include "Config.hpp"
 #include "DTCM.hpp"
@@ -28,12 +29,26 @@ private:
     // Configuration reference
     const Config& config;
     
+    // DTCM bytes each context's core class reaches from the DTCM base; empty
+    // without core classes, when every core reaches all of it
+    std::vector<uint64_t> contextDtcmSize;
+    
     // Callback function for scheduling events
     // This will be set by the Simulator to schedule MemRespDone events
     using EventSchedulerCallback = void(*)(Event event, void* context);
     EventSchedulerCallback eventScheduler;
     void* schedulerContext;
     
+    // Bank accesses from a core on the bank's own chiplet, and from others
+    uint64_t localBankAccesses;
+    uint64_t remoteBankAccesses;
+    
+    // Completion times of bank requests still in flight as a min-heap;
+    // kept only while occupancy tracking is on
+    std::vector<uint64_t> bankCompletions;
+    bool trackOccupancy;
+    size_t peakBankRequestsInFlight;
+    
     // Memory request structure for internal tracking
     struct MemoryRequest {
         uint64_t address;
@@ -62,7 +77,7 @@ public:
      * Issue a memory request (entry point)
      * @param address Memory address
      * @param rw Read or Write
-     * @param coreId Requesting core
+     * @param coreId Requesting core (thread context), which receives the response
      * @param taskInstanceId Task instance making request
      * @param currentTime Current simulation time
      */
@@ -136,6 +151,41 @@ public:
      * @return MainMemory pointer or nullptr
      */
     MainMemory* getMainMemory() const;
+    
+    // Bank accesses that stayed on the requesting core's chiplet
+    uint64_t getLocalBankAccesses() const { return localBankAccesses; }
+    
+    // Bank accesses that crossed to another chiplet
+    uint64_t getRemoteBankAccesses() const { return remoteBankAccesses; }
+    
+    /**
+     * Track the bank requests in flight (off by default; each bank access
+     * then costs a heap push)
+     * @param enabled Whether to track
+     */
+    void setOccupancyTracking(bool enabled);
+    
+    /**
+     * Bank requests issued and not yet answered; every one of them also
+     * holds the interconnect
+     * @param currentTime Current simulation time (never earlier than the last call)
+     * @return Requests in flight, 0 when tracking is off
+     */
+    size_t getBankRequestsInFlight(uint64_t currentTime);
+    
+    /**
+     * Cycle at which the n-th of the requests now in flight is answered
+     * @param n Number of answers waited for, 1 to getBankRequestsInFlight()
+     * @return Completion time of the n-th earliest request
+     */
+    uint64_t getBankRequestDoneTime(size_t n) const;
+    
+    // Most bank requests in flight at once while tracking
+    size_t getPeakBankRequestsInFlight() const { return peakBankRequestsInFlight; }
+    
+    // Requests the banks serve at once: port_limit per bank under the queue
+    // conflict policy, one per bank otherwise
+    int getBankPortCount() const;
 };
 
 #endif // MEMORYSYSTEM_HPP
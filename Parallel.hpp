@@ -0,0 +1,43 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Number of hardware threads, queried once (the query may hit the OS)
+inline size_t hardwareThreads() {
+    static const size_t kHardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    return kHardwareThreads;
+}
+
+/**
+ * Split [0, count) into contiguous chunks and call fn(begin, end) for each
+ * chunk on its own worker thread. Small ranges run inline on the caller.
+ * @param count Number of items
+ * @param minPerWorker Minimum items that justify an extra thread
+ * @param fn Callable taking (size_t begin, size_t end); chunks are disjoint
+ */
+template <typename Fn>
+void parallelFor(size_t count, size_t minPerWorker, Fn fn) {
+    size_t numWorkers = std::min(hardwareThreads(), count / std::max<size_t>(minPerWorker, 1) + 1);
+
+    if (numWorkers == 1) {
+        if (count > 0) {
+            fn(size_t(0), count);
+        }
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    size_t chunk = (count + numWorkers - 1) / numWorkers;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        workers.emplace_back(fn, begin, std::min(count, begin + chunk));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+#endif // PARALLEL_HPP
@@ -3,40 +3,210 @@
 
 #include "Types.hpp"
 #include "TaskGraph.hpp"
-#include <deque>
+#include "IdleCoreSet.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-class Scheduler {
+class StatsCollector;
+
+/**
+ * CorePool class
+ * Policy-independent half of a scheduler: which cores are idle, round-robin
+ * core selection (overall and per chiplet), and the dispatch and release of
+ * instances. Policies decide which instance a core runs next.
+ */
+class CorePool {
 public:
-    Scheduler(SchedulingPolicy policy, int numCores, TaskGraph* taskGraph);
-    
-    // Add a task instance to the ready queue
-    void addReady(int instanceId);
-    
-    // Select the next instance to dispatch based on policy
-    int selectNextInstance();
-    
+    CorePool(int numCores, TaskGraph* taskGraph, const std::vector<int>& coreChiplet = {});
+
     // Find an idle core using round-robin
     int selectIdleCore();
-    
-    // Dispatch an instance to a core
+
+    // Find an idle core of one chiplet, round-robin within the chiplet
+    int selectIdleCore(int chipletId);
+
+    // Lowest idle core in [begin, end), or -1
+    int firstIdleCore(int begin, int end) const {
+        int coreId = idleCores.next(begin);
+        return coreId >= begin && coreId < end ? coreId : -1;
+    }
+
+    // Dispatch an instance to a core; the instance starts at currentTime,
+    // which a modeled dispatch cost puts past the current cycle
     void dispatch(int instanceId, int coreId, uint64_t currentTime);
-    
+
     // Mark a core as idle
     void releaseCore(int coreId);
-    
-    // Check if there are ready instances
-    bool hasReadyInstances() const { return !readyQueue.empty(); }
-    
+
     // Check if a core is idle
-    bool isCoreIdle(int coreId) const { return coreIdle[coreId]; }
-    
+    bool isCoreIdle(int coreId) const { return idleCores.contains(coreId); }
+
+    // Idle core counts, overall and per chiplet
+    int idleCoreCount() const { return idleCores.count(); }
+    int idleCoreCount(int chipletId) const { return idleCores.countInChiplet(chipletId); }
+    bool hasIdleCores() const { return !idleCores.empty(); }
+
+    int coreCount() const { return idleCores.size(); }
+    int chipletCount() const { return idleCores.chipletCount(); }
+    int chipletOf(int coreId) const { return coreChiplet.empty() ? 0 : coreChiplet[coreId]; }
+    const std::vector<int>& getCoreChiplet() const { return coreChiplet; }
+    TaskGraph& getTaskGraph() const { return *taskGraph; }
+
 private:
-    SchedulingPolicy policy;
-    std::deque<int> readyQueue;      // Queue of ready instance IDs
-    std::vector<bool> coreIdle;      // Tracks which cores are available
+    std::vector<int> coreChiplet;    // Chiplet of each core (empty: all on chiplet 0)
+    IdleCoreSet idleCores;           // Tracks which cores are available
     int nextCoreRoundRobin;          // For round-robin core selection
+    std::vector<int> nextCoreInChiplet;  // Round-robin position per chiplet
     TaskGraph* taskGraph;            // Pointer to task graph for accessing instances
 };
 
+/*
+ * Scheduling policy requirements. A policy P used as Scheduler<P> provides
+ *
+ *   P(const CorePool& cores, Args...)           constructed once per run
+ *   void add(int instanceId, int producerCore,  queue a ready instance; the producer
+ *            const CorePool& cores)             is the core that released it, or -1
+ *   bool empty() const                          no ready instances queued
+ *   int next(int coreId, const CorePool& cores) remove the instance an idle core runs
+ *                                               next, or -1 to leave the core idle;
+ *                                               only called when not empty()
+ *
+ * and may provide
+ *
+ *   void dispatch(CorePool& cores, uint64_t currentTime,
+ *                 std::vector<std::pair<int, int>>& dispatched)
+ *       pair queued instances with idle cores (default: dispatchGreedy)
+ *   static constexpr bool kDispatchOnCompletion
+ *       false when a core freed by a completion waits for the completion's
+ *       TaskReady events instead of taking its next instance at once
+ *   void recordStats(StatsCollector& stats) const
+ *       report policy counters after the run
+ *
+ * Calls are resolved at compile time, so each policy's queue operations are
+ * inlined into the simulator's event handlers.
+ */
+
+template <typename P, typename = void>
+struct IsSchedulingPolicy : std::false_type {};
+
+template <typename P>
+struct IsSchedulingPolicy<P, std::void_t<
+    decltype(std::declval<P&>().add(0, 0, std::declval<const CorePool&>())),
+    decltype(static_cast<bool>(std::declval<const P&>().empty())),
+    decltype(static_cast<int>(std::declval<P&>().next(0, std::declval<const CorePool&>())))>>
+    : std::true_type {};
+
+template <typename P, typename = void>
+struct PolicyHasDispatch : std::false_type {};
+
+template <typename P>
+struct PolicyHasDispatch<P, std::void_t<decltype(std::declval<P&>().dispatch(
+    std::declval<CorePool&>(), uint64_t(0), std::declval<std::vector<std::pair<int, int>>&>()))>>
+    : std::true_type {};
+
+template <typename P, typename = void>
+struct PolicyHasStats : std::false_type {};
+
+template <typename P>
+struct PolicyHasStats<P, std::void_t<decltype(
+    std::declval<const P&>().recordStats(std::declval<StatsCollector&>()))>>
+    : std::true_type {};
+
+template <typename P, typename = void>
+struct PolicyDispatchesOnCompletion : std::true_type {};
+
+template <typename P>
+struct PolicyDispatchesOnCompletion<P, std::void_t<decltype(P::kDispatchOnCompletion)>>
+    : std::integral_constant<bool, P::kDispatchOnCompletion> {};
+
+/**
+ * Pair queued instances with idle cores until either runs out, each idle
+ * core (round-robin) taking the policy's next instance for it
+ */
+template <typename Policy>
+void dispatchGreedy(Policy& policy, CorePool& cores, uint64_t currentTime,
+                    std::vector<std::pair<int, int>>& dispatched) {
+    while (!policy.empty() && cores.hasIdleCores()) {
+        int coreId = cores.selectIdleCore();
+        int instanceId = policy.next(coreId, cores);
+        if (instanceId == -1) {
+            break;
+        }
+        cores.dispatch(instanceId, coreId, currentTime);
+        dispatched.emplace_back(instanceId, coreId);
+    }
+}
+
+/**
+ * Scheduler class template
+ * A CorePool driven by one scheduling policy, fixed at compile time
+ */
+template <typename Policy>
+class Scheduler : public CorePool {
+    static_assert(IsSchedulingPolicy<Policy>::value,
+                  "Scheduling policies need add(), empty() and next(); see Scheduler.hpp");
+
+public:
+    using PolicyType = Policy;
+
+    // Whether a core freed by a completion takes its next instance at once
+    static constexpr bool kDispatchOnCompletion = PolicyDispatchesOnCompletion<Policy>::value;
+
+    /**
+     * @param numCores Number of cores
+     * @param taskGraph Task graph whose instances are scheduled
+     * @param coreChiplet Chiplet of each core; empty puts all cores on chiplet 0
+     * @param policyArgs Arguments of the policy after the core pool
+     */
+    template <typename... Args>
+    Scheduler(int numCores, TaskGraph* taskGraph, const std::vector<int>& coreChiplet,
+              Args&&... policyArgs)
+        : CorePool(numCores, taskGraph, coreChiplet),
+          policy(static_cast<const CorePool&>(*this), std::forward<Args>(policyArgs)...) {}
+
+    /**
+     * Add a task instance to the ready queue
+     * @param instanceId Ready instance
+     * @param producerCore Core whose completion released the instance, or -1
+     */
+    void addReady(int instanceId, int producerCore = -1) {
+        policy.add(instanceId, producerCore, *this);
+    }
+
+    // Check if there are ready instances
+    bool hasReadyInstances() const { return !policy.empty(); }
+
+    // Select the next instance for a core that has become idle (-1: none)
+    int selectInstanceForCore(int coreId) {
+        return policy.empty() ? -1 : policy.next(coreId, *this);
+    }
+
+    /**
+     * Pair ready instances with idle cores until either runs out
+     * @param currentTime Dispatch time
+     * @param dispatched Receives (instanceId, coreId) pairs in dispatch order
+     */
+    void dispatchToIdleCores(uint64_t currentTime, std::vector<std::pair<int, int>>& dispatched) {
+        if constexpr (PolicyHasDispatch<Policy>::value) {
+            policy.dispatch(*this, currentTime, dispatched);
+        } else {
+            dispatchGreedy(policy, *this, currentTime, dispatched);
+        }
+    }
+
+    // Report the policy's counters, if it keeps any
+    void recordStats(StatsCollector& stats) const {
+        if constexpr (PolicyHasStats<Policy>::value) {
+            policy.recordStats(stats);
+        }
+    }
+
+    const Policy& getPolicy() const { return policy; }
+
+private:
+    Policy policy;
+};
+
 #endif // SCHEDULER_HPP
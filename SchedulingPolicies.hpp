@@ -0,0 +1,890 @@
+#ifndef SCHEDULINGPOLICIES_HPP
+#define SCHEDULINGPOLICIES_HPP
+
+#include "Scheduler.hpp"
+#include "ChipletAffinity.hpp"
+#include "MemorySystem.hpp"
+#include "StatsCollector.hpp"
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/*
+ * Built-in scheduling policies, one class per SchedulingPolicy value. Each
+ * meets the requirements listed in Scheduler.hpp and is instantiated as
+ * Scheduler<...> by Simulator::setup.
+ */
+
+/**
+ * PriorityReadyQueue class
+ * Ready instances by key, smallest first; ties go to the instance that
+ * became ready first
+ */
+class PriorityReadyQueue {
+public:
+    PriorityReadyQueue() : arrivals(0) {}
+
+    void push(int64_t key, int instanceId) { heap.push({key, arrivals++, instanceId}); }
+    bool empty() const { return heap.empty(); }
+
+    int pop() {
+        int instanceId = heap.top().instanceId;
+        heap.pop();
+        return instanceId;
+    }
+
+private:
+    struct Entry {
+        int64_t key;
+        uint64_t arrival;
+        int instanceId;
+    };
+    struct Compare {
+        bool operator()(const Entry& a, const Entry& b) const {
+            if (a.key != b.key) {
+                return a.key > b.key;
+            }
+            return a.arrival > b.arrival;
+        }
+    };
+
+    std::priority_queue<Entry, std::vector<Entry>, Compare> heap;
+    uint64_t arrivals;           // Instances pushed so far, orders ties
+};
+
+/**
+ * ChipletQueues class
+ * One FIFO of ready instances per chiplet, plus a last queue for instances
+ * without a chiplet
+ */
+class ChipletQueues {
+public:
+    explicit ChipletQueues(int numChiplets) : queues(numChiplets + 1), queued(0), arrivals(0) {}
+
+    void push(size_t queue, int instanceId) {
+        queues[queue].push_back({arrivals++, instanceId});
+        queued++;
+    }
+
+    bool empty() const { return queued == 0; }
+    bool empty(size_t queue) const { return queues[queue].empty(); }
+    size_t homeless() const { return queues.size() - 1; }
+
+    // Pop the front of a chiplet's queue, or the oldest instance of any
+    // queue when that one is empty (chiplet -1 always takes the oldest)
+    int pop(int chiplet) {
+        size_t queue = queues.size();
+        if (chiplet >= 0 && static_cast<size_t>(chiplet) < queues.size() && !queues[chiplet].empty()) {
+            queue = chiplet;
+        } else {
+            for (size_t q = 0; q < queues.size(); q++) {
+                if (!queues[q].empty() &&
+                    (queue == queues.size() || queues[q].front().arrival < queues[queue].front().arrival)) {
+                    queue = q;
+                }
+            }
+        }
+        if (queue == queues.size()) {
+            return -1;
+        }
+        return popFront(queue);
+    }
+
+    // Pop the front of the longest queue (lowest index on ties)
+    int popLongest() {
+        size_t source = 0;
+        for (size_t q = 1; q < queues.size(); q++) {
+            if (queues[q].size() > queues[source].size()) {
+                source = q;
+            }
+        }
+        return popFront(source);
+    }
+
+private:
+    struct Entry {
+        uint64_t arrival;
+        int instanceId;
+    };
+
+    std::vector<std::deque<Entry>> queues;
+    size_t queued;               // Instances in all queues
+    uint64_t arrivals;           // Instances pushed so far, orders queue fronts
+
+    int popFront(size_t queue) {
+        int instanceId = queues[queue].front().instanceId;
+        queues[queue].pop_front();
+        queued--;
+        return instanceId;
+    }
+};
+
+// FIFO: Instances in the order they became ready
+class FifoPolicy {
+public:
+    explicit FifoPolicy(const CorePool&) {}
+
+    void add(int instanceId, int, const CorePool&) { readyQueue.push_back(instanceId); }
+    bool empty() const { return readyQueue.empty(); }
+
+    int next(int, const CorePool&) {
+        int instanceId = readyQueue.front();
+        readyQueue.pop_front();
+        return instanceId;
+    }
+
+private:
+    std::deque<int> readyQueue;  // Queue of ready instance IDs
+};
+
+// RoundRobin: Also FIFO for task selection, core selection handles round-robin
+class RoundRobinPolicy : public FifoPolicy {
+public:
+    using FifoPolicy::FifoPolicy;
+};
+
+// ShortestOpsFirst: Instance with the fewest remaining operations
+class ShortestOpsFirstPolicy {
+public:
+    explicit ShortestOpsFirstPolicy(const CorePool&) {}
+
+    void add(int instanceId, int, const CorePool& cores) {
+        // A ready instance has not run, so its remaining ops are fixed until dispatch
+        const TaskGraph& graph = cores.getTaskGraph();
+        const InstanceTable& instances = graph.getInstances();
+        size_t programLength = graph.getProgramLength(instances.taskId(instanceId));
+        heap.push(static_cast<int64_t>(programLength - instances.opIndex(instanceId)), instanceId);
+    }
+
+    bool empty() const { return heap.empty(); }
+    int next(int, const CorePool&) { return heap.pop(); }
+
+private:
+    PriorityReadyQueue heap;
+};
+
+// CriticalPath: Instance with the longest chain of work after it
+class CriticalPathPolicy {
+public:
+    /**
+     * @param ranks Upward rank per task index (see TaskBound::instanceRank)
+     */
+    CriticalPathPolicy(const CorePool&, std::vector<uint64_t> ranks) : taskRanks(std::move(ranks)) {}
+
+    void add(int instanceId, int, const CorePool& cores) {
+        // Highest rank first: negate for the min-heap
+        const TaskGraph& graph = cores.getTaskGraph();
+        int taskIndex = graph.getTaskIndex(graph.getInstances().taskId(instanceId));
+        uint64_t rank = static_cast<size_t>(taskIndex) < taskRanks.size() ? taskRanks[taskIndex] : 0;
+        heap.push(-static_cast<int64_t>(rank), instanceId);
+    }
+
+    bool empty() const { return heap.empty(); }
+    int next(int, const CorePool&) { return heap.pop(); }
+
+private:
+    std::vector<uint64_t> taskRanks;  // Priority per task index
+    PriorityReadyQueue heap;
+};
+
+// EarliestDeadline: Instance with the earliest absolute deadline (ready
+// time plus its task's deadline); instances without one run after all
+// that have one, in ready order
+class EarliestDeadlinePolicy {
+public:
+    explicit EarliestDeadlinePolicy(const CorePool&) {}
+
+    void add(int instanceId, int, const CorePool& cores) {
+        const TaskGraph& graph = cores.getTaskGraph();
+        const InstanceTable& instances = graph.getInstances();
+        const Task& task = graph.getTasks()[graph.getTaskIndex(instances.taskId(instanceId))];
+        int64_t key = std::numeric_limits<int64_t>::max();
+        if (task.deadline > 0) {
+            key = static_cast<int64_t>(instances.readyTime(instanceId) + task.deadline);
+        }
+        heap.push(key, instanceId);
+    }
+
+    bool empty() const { return heap.empty(); }
+    int next(int, const CorePool&) { return heap.pop(); }
+
+private:
+    PriorityReadyQueue heap;
+};
+
+// EarliestFinishTime: HEFT list scheduling. Instances go in critical_path
+// order (highest upward rank first, then ready order), each to the core
+// class where it is estimated to finish first. A class is available now if
+// one of its cores is idle, else when the first of its running instances is
+// estimated to finish, plus the work of instances already waiting for it
+// shared over its cores. An instance waits for a busy class rather than
+// start on a slower one that would finish it later. A task's core class
+// hint wins whenever a core of that class is idle.
+class EarliestFinishTimePolicy {
+public:
+    // Placement needs the current cycle, which only dispatch() is given
+    static constexpr bool kDispatchOnCompletion = false;
+
+    // Cost of a task on a class that lacks one of its op types
+    static constexpr uint64_t kIneligible = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * @param coreClass Core class of each core
+     * @param ranks Priority per task index (higher runs first)
+     * @param costs Instance cost of each task index on each class, classes
+     *              of a task adjacent; kIneligible where it cannot run
+     * @param hints Preferred class of each task index, -1 for none
+     * @param names Name of each class, for the statistics
+     */
+    EarliestFinishTimePolicy(const CorePool& cores, std::vector<int> coreClass, std::vector<uint64_t> ranks,
+                             std::vector<uint64_t> costs, std::vector<int> hints, std::vector<std::string> names)
+        : coreClasses(std::move(coreClass)), taskRanks(std::move(ranks)), classCosts(std::move(costs)),
+          taskHints(std::move(hints)), classNames(std::move(names)),
+          numClasses(static_cast<int>(classNames.size())), taskQueues(taskHints.size()),
+          classRuns(numClasses), classCores(numClasses, 0), busyUntil(cores.coreCount(), 0),
+          finishHeaps(numClasses), classDispatches(numClasses, 0), arrivals(0), queued(0), heldBack(0) {
+        // Cores of a class as runs of consecutive ids, searched for idle ones
+        for (int coreId = 0; coreId < cores.coreCount(); coreId++) {
+            std::vector<std::pair<int, int>>& runs = classRuns[coreClasses[coreId]];
+            if (!runs.empty() && runs.back().second == coreId) {
+                runs.back().second++;
+            } else {
+                runs.emplace_back(coreId, coreId + 1);
+            }
+            classCores[coreClasses[coreId]]++;
+        }
+    }
+
+    void add(int instanceId, int, const CorePool& cores) {
+        const TaskGraph& graph = cores.getTaskGraph();
+        size_t taskIndex = static_cast<size_t>(graph.getTaskIndex(graph.getInstances().taskId(instanceId)));
+        std::deque<Entry>& queue = taskQueues[taskIndex];
+        queue.push_back({arrivals++, instanceId, false});
+        if (queue.size() == 1) {
+            pushFront(taskIndex);
+        }
+        queued++;
+    }
+
+    bool empty() const { return queued == 0; }
+
+    // First instance in priority order the core's class can run, without estimates
+    int next(int coreId, const CorePool&) {
+        size_t best = taskQueues.size();
+        for (size_t t = 0; t < taskQueues.size(); t++) {
+            if (!taskQueues[t].empty() && cost(t, coreClasses[coreId]) != kIneligible &&
+                (best == taskQueues.size() || frontKey(t) < frontKey(best))) {
+                best = t;
+            }
+        }
+        return best < taskQueues.size() ? pop(best) : -1;
+    }
+
+    void dispatch(CorePool& cores, uint64_t currentTime, std::vector<std::pair<int, int>>& dispatched) {
+        // Tasks in the priority order of their first queued instance. The
+        // instances of a task are alike, so while one waits for a busy
+        // class the next is placed behind it; the first goes wherever one
+        // of them may start now, and the task waits if none may. Instances
+        // that wait count toward the backlog of later tasks; after a
+        // dispatch the task is scanned again and counts them then.
+        std::vector<Front> waiting;
+        std::vector<uint64_t> backlog(numClasses, 0);  // Work waiting for each class
+        while (!fronts.empty() && cores.hasIdleCores()) {
+            Front front = fronts.top();
+            fronts.pop();
+            size_t taskIndex = front.second;
+            std::deque<Entry>& queue = taskQueues[taskIndex];
+            if (queue.empty() || frontKey(taskIndex) != front.first) {
+                continue;  // Taken by next()
+            }
+            int coreId = -1;
+            std::vector<uint64_t> taskBacklog = backlog;
+            for (Entry& entry : queue) {
+                int waitClass = -1;
+                coreId = place(taskIndex, entry, cores, currentTime, taskBacklog, waitClass);
+                if (coreId != -1 || waitClass == -1) {
+                    break;
+                }
+                taskBacklog[waitClass] += cost(taskIndex, waitClass);
+            }
+            if (coreId == -1) {
+                backlog = std::move(taskBacklog);
+                waiting.push_back(front);
+                continue;
+            }
+            int instanceId = pop(taskIndex);
+            cores.dispatch(instanceId, coreId, currentTime);
+            dispatched.emplace_back(instanceId, coreId);
+
+            int coreClass = coreClasses[coreId];
+            busyUntil[coreId] = currentTime + cost(taskIndex, coreClass);
+            finishHeaps[coreClass].push({busyUntil[coreId], coreId});
+            classDispatches[coreClass]++;
+        }
+        for (const auto& front : waiting) {
+            fronts.push(front);
+        }
+    }
+
+    void recordStats(StatsCollector& stats) const {
+        stats.recordClassPlacement(classNames, classDispatches, heldBack);
+    }
+
+private:
+    struct Entry {
+        uint64_t arrival;
+        int instanceId;
+        bool heldBack;               // Has waited while a core able to run it was idle
+    };
+    using Key = std::pair<uint64_t, uint64_t>;    // (inverted rank, arrival)
+    using Front = std::pair<Key, size_t>;         // Key of a task's first instance, task index
+    using Finish = std::pair<uint64_t, size_t>;   // Estimated finish, core
+    template <typename T>
+    using MinHeap = std::priority_queue<T, std::vector<T>, std::greater<T>>;
+
+    std::vector<int> coreClasses;    // Per core
+    std::vector<uint64_t> taskRanks; // Per task index
+    std::vector<uint64_t> classCosts;
+    std::vector<int> taskHints;      // Per task index
+    std::vector<std::string> classNames;
+    int numClasses;
+    std::vector<std::deque<Entry>> taskQueues;   // FIFO per task index
+    MinHeap<Front> fronts;           // First instance of each task, lazily updated
+    std::vector<std::vector<std::pair<int, int>>> classRuns;  // [begin, end) core runs per class
+    std::vector<uint64_t> classCores;
+    std::vector<uint64_t> busyUntil; // Estimated finish of each core's instance
+    std::vector<MinHeap<Finish>> finishHeaps;  // Estimated finishes per class, stale entries skipped
+    std::vector<uint64_t> classDispatches;
+    uint64_t arrivals;               // Instances added so far
+    size_t queued;
+    uint64_t heldBack;               // Instances that waited for a faster class
+
+    // Priority of a task's first queued instance, smallest first
+    Key frontKey(size_t taskIndex) const {
+        return {~taskRanks[taskIndex], taskQueues[taskIndex].front().arrival};
+    }
+
+    void pushFront(size_t taskIndex) {
+        fronts.push({frontKey(taskIndex), taskIndex});
+    }
+
+    uint64_t cost(size_t taskIndex, int coreClass) const {
+        return classCosts[taskIndex * numClasses + coreClass];
+    }
+
+    int idleCore(int coreClass, const CorePool& cores) const {
+        for (const auto& run : classRuns[coreClass]) {
+            int coreId = cores.firstIdleCore(run.first, run.second);
+            if (coreId != -1) {
+                return coreId;
+            }
+        }
+        return -1;
+    }
+
+    // Estimated cycle the first busy core of a class finishes, dropping
+    // estimates of cores that have gone idle or taken another instance
+    uint64_t earliestFree(int coreClass, const CorePool& cores) {
+        MinHeap<Finish>& heap = finishHeaps[coreClass];
+        while (!heap.empty()) {
+            const Finish& top = heap.top();
+            int coreId = static_cast<int>(top.second);
+            if (!cores.isCoreIdle(coreId) && busyUntil[coreId] == top.first) {
+                return top.first;
+            }
+            heap.pop();
+        }
+        return 0;
+    }
+
+    // Idle core to run an instance of the task on now, or -1 to wait.
+    // waitClass receives the busy class it waits for while a core able to
+    // run it is idle, and stays -1 otherwise.
+    int place(size_t taskIndex, Entry& entry, const CorePool& cores, uint64_t currentTime,
+              const std::vector<uint64_t>& backlog, int& waitClass) {
+        int hint = taskHints[taskIndex];
+        if (hint >= 0) {
+            int coreId = idleCore(hint, cores);
+            if (coreId != -1) {
+                return coreId;
+            }
+        }
+
+        // Earliest finish, then earliest start: an idle class beats an equal busy one
+        int bestCore = -1;
+        int bestClass = -1;
+        uint64_t bestFinish = kIneligible;
+        uint64_t bestStart = kIneligible;
+        bool idleEligible = false;
+        for (int k = 0; k < numClasses; k++) {
+            uint64_t instanceCost = cost(taskIndex, k);
+            if (instanceCost == kIneligible) {
+                continue;
+            }
+            int coreId = idleCore(k, cores);
+            uint64_t start = currentTime;
+            if (coreId == -1) {
+                start = std::max(currentTime, earliestFree(k, cores)) + backlog[k] / classCores[k];
+            }
+            uint64_t finish = start + instanceCost;
+            idleEligible = idleEligible || coreId != -1;
+            if (finish < bestFinish || (finish == bestFinish && start < bestStart)) {
+                bestCore = coreId;
+                bestClass = k;
+                bestFinish = finish;
+                bestStart = start;
+            }
+        }
+
+        if (bestCore == -1 && idleEligible) {
+            waitClass = bestClass;
+            if (!entry.heldBack) {
+                entry.heldBack = true;
+                heldBack++;
+            }
+        }
+        return bestCore;
+    }
+
+    int pop(size_t taskIndex) {
+        std::deque<Entry>& queue = taskQueues[taskIndex];
+        int instanceId = queue.front().instanceId;
+        queue.pop_front();
+        if (!queue.empty()) {
+            pushFront(taskIndex);
+        }
+        queued--;
+        return instanceId;
+    }
+};
+
+// Affinity: FIFO per home chiplet; idle cores prefer instances homed on
+// their own chiplet
+class AffinityPolicy {
+public:
+    /**
+     * @param homes Data placement of the task graph (outlives the scheduler), or nullptr
+     */
+    AffinityPolicy(const CorePool& cores, const ChipletAffinity* homes)
+        : affinity(homes), homeQueues(cores.chipletCount()) {}
+
+    void add(int instanceId, int, const CorePool& cores) {
+        // The home is fixed for the instance, so it is looked up once here
+        int home = -1;
+        if (affinity != nullptr) {
+            const TaskGraph& graph = cores.getTaskGraph();
+            const InstanceTable& instances = graph.getInstances();
+            home = affinity->homeChiplet(graph.getTaskIndex(instances.taskId(instanceId)),
+                                         instances.executionIndex(instanceId));
+        }
+        homeQueues.push(home >= 0 && home < cores.chipletCount() ? home : homeQueues.homeless(), instanceId);
+    }
+
+    bool empty() const { return homeQueues.empty(); }
+    int next(int coreId, const CorePool& cores) { return homeQueues.pop(cores.chipletOf(coreId)); }
+
+    void dispatch(CorePool& cores, uint64_t currentTime, std::vector<std::pair<int, int>>& dispatched) {
+        // Idle cores first take instances homed on their own chiplet
+        for (int chiplet = 0; chiplet < cores.chipletCount(); chiplet++) {
+            while (!homeQueues.empty(chiplet)) {
+                int coreId = cores.selectIdleCore(chiplet);
+                if (coreId == -1) {
+                    break;
+                }
+                int instanceId = homeQueues.pop(chiplet);
+                cores.dispatch(instanceId, coreId, currentTime);
+                dispatched.emplace_back(instanceId, coreId);
+            }
+        }
+
+        // Remaining idle cores take the next instance, local or not
+        dispatchGreedy(*this, cores, currentTime, dispatched);
+    }
+
+private:
+    const ChipletAffinity* affinity;  // Home chiplets, or nullptr
+    ChipletQueues homeQueues;
+};
+
+// WorkStealing: Per-core deques; the owner pushes and pops at the back of
+// its deque, thieves take from the front
+class WorkStealingPolicy {
+public:
+    static constexpr bool kDispatchOnCompletion = false;
+
+    /**
+     * @param victim Victim choice
+     * @param latency Cycles from a steal to the stolen instance's dispatch
+     * @param remotePenalty Extra cycles when the victim is on another chiplet
+     * @param seed Seed of the random victim choice
+     */
+    WorkStealingPolicy(const CorePool& cores, StealVictim victim, uint64_t latency,
+                       uint64_t remotePenalty, uint32_t seed)
+        : coreDeques(cores.coreCount()), stealableCores(cores.coreCount(), cores.getCoreChiplet()),
+          dequeQueued(0), stealVictim(victim), stealLatency(latency), remoteStealPenalty(remotePenalty),
+          stealRng(seed), localDispatches(0), steals(0), remoteSteals(0) {
+        for (int core = 0; core < cores.coreCount(); core++) {
+            stealableCores.erase(core);
+        }
+    }
+
+    void add(int instanceId, int producerCore, const CorePool&) {
+        if (producerCore >= 0) {
+            // Successors stay with the core that produced their inputs; sources
+            // and lazily created instances go to the shared queue
+            coreDeques[producerCore].push_back(instanceId);
+            stealableCores.insert(producerCore);
+            dequeQueued++;
+            return;
+        }
+        readyQueue.push_back(instanceId);
+    }
+
+    bool empty() const { return readyQueue.empty() && dequeQueued == 0; }
+
+    // The core's own deque, then the shared queue; never steals (-1 when it
+    // would have to)
+    int next(int coreId, const CorePool&) {
+        if (!coreDeques[coreId].empty()) {
+            localDispatches++;
+            return popDeque(coreId, true);
+        }
+        if (readyQueue.empty()) {
+            return -1;
+        }
+        int instanceId = readyQueue.front();
+        readyQueue.pop_front();
+        return instanceId;
+    }
+
+    void dispatch(CorePool& cores, uint64_t currentTime, std::vector<std::pair<int, int>>& dispatched) {
+        // Idle cores with queued work run their newest instance
+        for (int start = 0; start < stealableCores.size(); ) {
+            int coreId = stealableCores.next(start);
+            if (coreId < start) {
+                break;  // None left at or after start (the search wraps)
+            }
+            start = coreId + 1;
+            if (cores.isCoreIdle(coreId)) {
+                localDispatches++;
+                int instanceId = popDeque(coreId, true);
+                cores.dispatch(instanceId, coreId, currentTime);
+                dispatched.emplace_back(instanceId, coreId);
+            }
+        }
+
+        // Then the shared queue, free to any idle core
+        while (!readyQueue.empty() && cores.hasIdleCores()) {
+            int coreId = cores.selectIdleCore();
+            int instanceId = readyQueue.front();
+            readyQueue.pop_front();
+            cores.dispatch(instanceId, coreId, currentTime);
+            dispatched.emplace_back(instanceId, coreId);
+        }
+
+        // Cores still idle steal the oldest instance of a victim's deque
+        while (dequeQueued > 0 && cores.hasIdleCores()) {
+            int thief = cores.selectIdleCore();
+            int victim = selectVictim(thief, cores);
+            uint64_t latency = stealLatency;
+            steals++;
+            if (cores.chipletOf(victim) != cores.chipletOf(thief)) {
+                latency += remoteStealPenalty;
+                remoteSteals++;
+            }
+            int instanceId = popDeque(victim, false);
+            cores.dispatch(instanceId, thief, currentTime + latency);
+            dispatched.emplace_back(instanceId, thief);
+        }
+    }
+
+    // Instances run by the core that released them, and steals in total and
+    // from another chiplet
+    void recordStats(StatsCollector& stats) const {
+        stats.recordWorkStealing(localDispatches, steals, remoteSteals);
+    }
+
+private:
+    std::deque<int> readyQueue;      // Shared queue of instances without a producer
+    std::vector<std::deque<int>> coreDeques;
+    IdleCoreSet stealableCores;      // Cores with a non-empty deque
+    size_t dequeQueued;              // Instances in all deques
+    StealVictim stealVictim;
+    uint64_t stealLatency;
+    uint64_t remoteStealPenalty;
+    std::mt19937 stealRng;
+    uint64_t localDispatches;
+    uint64_t steals;
+    uint64_t remoteSteals;
+
+    // Pop from the back (owner) or front (thief) of a core's deque
+    int popDeque(int coreId, bool back) {
+        std::deque<int>& deque = coreDeques[coreId];
+        int instanceId;
+        if (back) {
+            instanceId = deque.back();
+            deque.pop_back();
+        } else {
+            instanceId = deque.front();
+            deque.pop_front();
+        }
+        if (deque.empty()) {
+            stealableCores.erase(coreId);
+        }
+        dequeQueued--;
+        return instanceId;
+    }
+
+    // Core to steal from for an idle thief, uniform over the cores with
+    // queued work (within the thief's chiplet first in chiplet mode); some
+    // deque must be non-empty
+    int selectVictim(int thief, const CorePool& cores) {
+        if (stealVictim == StealVictim::Chiplet) {
+            int chiplet = cores.chipletOf(thief);
+            int local = stealableCores.countInChiplet(chiplet);
+            if (local > 0) {
+                return stealableCores.nthInChiplet(chiplet, static_cast<int>(stealRng() % static_cast<uint32_t>(local)));
+            }
+        }
+        return stealableCores.nth(static_cast<int>(stealRng() % static_cast<uint32_t>(stealableCores.count())));
+    }
+};
+
+// Hierarchical: One queue and scheduler per chiplet with a modeled dispatch
+// cost, plus a balancer. Each chiplet scheduler and the balancer make one
+// decision at a time, so each is free again at a known cycle.
+class HierarchicalPolicy {
+public:
+    static constexpr bool kDispatchOnCompletion = false;
+
+    /**
+     * @param latency Cycles from a dispatch decision to the instance's start
+     * @param interval Cycles a chiplet scheduler is busy per dispatch
+     * @param migration Cycles the balancer is busy per migrated instance
+     */
+    HierarchicalPolicy(const CorePool& cores, uint64_t latency, uint64_t interval, uint64_t migration)
+        : homeQueues(cores.chipletCount()), dispatchLatency(latency), dispatchInterval(interval),
+          migrationCost(migration), schedulerFreeAt(cores.chipletCount(), 0), balancerFreeAt(0),
+          chipletLoads(cores.chipletCount()), nextSourceChiplet(0) {}
+
+    void add(int instanceId, int producerCore, const CorePool& cores) {
+        // Successors queue at the producer's chiplet; the balancer spreads
+        // instances without a producer over the chiplets round-robin
+        int chiplet;
+        if (producerCore >= 0) {
+            chiplet = cores.chipletOf(producerCore);
+        } else {
+            chiplet = nextSourceChiplet;
+            nextSourceChiplet = (nextSourceChiplet + 1) % cores.chipletCount();
+        }
+        homeQueues.push(chiplet, instanceId);
+    }
+
+    bool empty() const { return homeQueues.empty(); }
+    int next(int coreId, const CorePool& cores) { return homeQueues.pop(cores.chipletOf(coreId)); }
+
+    void dispatch(CorePool& cores, uint64_t currentTime, std::vector<std::pair<int, int>>& dispatched) {
+        // Each chiplet scheduler serves the idle cores of its chiplet
+        for (int chiplet = 0; chiplet < cores.chipletCount() && cores.hasIdleCores(); chiplet++) {
+            while (!homeQueues.empty(chiplet)) {
+                int coreId = cores.selectIdleCore(chiplet);
+                if (coreId == -1) {
+                    break;
+                }
+                int instanceId = homeQueues.pop(chiplet);
+                cores.dispatch(instanceId, coreId, bookDispatch(chiplet, currentTime));
+                dispatched.emplace_back(instanceId, coreId);
+            }
+        }
+
+        // The balancer moves work from the longest queue to chiplets whose
+        // cores would otherwise idle; the destination scheduler then dispatches
+        while (!homeQueues.empty() && cores.hasIdleCores()) {
+            int coreId = cores.selectIdleCore();
+            int instanceId = homeQueues.popLongest();
+
+            uint64_t start = std::max(currentTime, balancerFreeAt);
+            balancerFreeAt = start + migrationCost;
+            balancerLoad.dispatches++;
+            balancerLoad.busyCycles += migrationCost;
+            balancerLoad.queueingDelay += start - currentTime;
+            cores.dispatch(instanceId, coreId, bookDispatch(cores.chipletOf(coreId), balancerFreeAt));
+            dispatched.emplace_back(instanceId, coreId);
+        }
+    }
+
+    // Loads: one per chiplet scheduler, and the balancer's
+    void recordStats(StatsCollector& stats) const {
+        stats.recordSchedulerLoads(chipletLoads, balancerLoad);
+    }
+
+    const std::vector<SchedulerLoad>& getChipletLoads() const { return chipletLoads; }
+    const SchedulerLoad& getBalancerLoad() const { return balancerLoad; }
+
+private:
+    ChipletQueues homeQueues;
+    uint64_t dispatchLatency;
+    uint64_t dispatchInterval;
+    uint64_t migrationCost;
+    std::vector<uint64_t> schedulerFreeAt;  // Per chiplet
+    uint64_t balancerFreeAt;
+    std::vector<SchedulerLoad> chipletLoads;
+    SchedulerLoad balancerLoad;
+    int nextSourceChiplet;           // Round-robin placement of instances without a producer
+
+    // Book a dispatch decision of a chiplet scheduler for an instance handed
+    // to it at readyAt; returns the cycle the instance starts
+    uint64_t bookDispatch(int chiplet, uint64_t readyAt) {
+        uint64_t decision = std::max(readyAt, schedulerFreeAt[chiplet]);
+        schedulerFreeAt[chiplet] = decision + dispatchInterval;
+
+        SchedulerLoad& load = chipletLoads[chiplet];
+        load.dispatches++;
+        load.busyCycles += dispatchInterval;
+        load.queueingDelay += decision - readyAt;
+        return decision + dispatchLatency;
+    }
+};
+
+// BandwidthAware: FIFO admission control. While the bank requests in
+// flight reach the limit, idle cores take compute-bound instances ahead of
+// memory-bound ones; a memory-bound instance left over starts once enough
+// requests are answered. An admitted instance counts as the requests its
+// load/store queue can hold at once.
+class BandwidthAwarePolicy {
+public:
+    static constexpr bool kDispatchOnCompletion = false;
+
+    /**
+     * @param memoryBound Whether each task (by index) is memory-bound
+     * @param memoryOps Memory ops of one instance of each task (by index)
+     * @param lsqDepth Load/store queue entries of a thread context
+     * @param memory Memory system with occupancy tracking on (outlives the scheduler);
+     *               must not be null
+     * @param occupancyThreshold In-flight bank requests per bank port that stop
+     *                           memory-bound dispatch
+     */
+    BandwidthAwarePolicy(const CorePool&, std::vector<char> memoryBound, std::vector<uint64_t> memoryOps,
+                         int lsqDepth, MemorySystem* memory, double occupancyThreshold)
+        : memoryBoundTasks(std::move(memoryBound)), taskMemoryOps(std::move(memoryOps)),
+          queueDepth(static_cast<uint64_t>(std::max(lsqDepth, 1))), memory(memory),
+          admissionLimit(limitFor(memory, occupancyThreshold)),
+          arrivals(0), throttled(0), interleaved(0) {}
+
+    void add(int instanceId, int, const CorePool& cores) {
+        const TaskGraph& graph = cores.getTaskGraph();
+        size_t taskIndex = static_cast<size_t>(graph.getTaskIndex(graph.getInstances().taskId(instanceId)));
+        if (taskIndex < memoryBoundTasks.size() && memoryBoundTasks[taskIndex]) {
+            uint64_t ops = taskIndex < taskMemoryOps.size() ? taskMemoryOps[taskIndex] : 1;
+            memoryQueue.push_back({arrivals++, instanceId, static_cast<size_t>(std::min(ops, queueDepth))});
+        } else {
+            computeQueue.push_back({arrivals++, instanceId, 0});
+        }
+    }
+
+    bool empty() const { return memoryQueue.empty() && computeQueue.empty(); }
+
+    // Oldest instance of either class; admission is only applied by dispatch()
+    int next(int, const CorePool&) { return pop(memoryFirst()); }
+
+    void dispatch(CorePool& cores, uint64_t currentTime, std::vector<std::pair<int, int>>& dispatched) {
+        // Each memory-bound instance admitted here adds the requests its
+        // load/store queue can keep in flight: min(depth, its memory ops)
+        size_t inFlight = memory->getBankRequestsInFlight(currentTime);
+        size_t admitted = 0;
+        while (!empty() && cores.hasIdleCores()) {
+            bool memoryOldest = memoryFirst();
+            uint64_t start = currentTime;
+            int instanceId;
+            if (memoryOldest && inFlight + admitted < admissionLimit) {
+                admitted += memoryQueue.front().requests;
+                instanceId = pop(true);
+            } else if (!computeQueue.empty()) {
+                if (memoryOldest) {
+                    interleaved++;
+                }
+                instanceId = pop(false);
+            } else {
+                // Wait for as many answers as the instance is over the limit;
+                // past the requests in flight the wait is unknown, and the
+                // completions of the running instances dispatch it later
+                size_t answers = inFlight + admitted - admissionLimit + 1;
+                throttled++;
+                if (answers > inFlight) {
+                    break;
+                }
+                start = memory->getBankRequestDoneTime(answers);
+                admitted += memoryQueue.front().requests;
+                instanceId = pop(true);
+            }
+            int coreId = cores.selectIdleCore();
+            cores.dispatch(instanceId, coreId, start);
+            dispatched.emplace_back(instanceId, coreId);
+        }
+    }
+
+    void recordStats(StatsCollector& stats) const {
+        stats.recordAdmission(throttled, interleaved, memory->getPeakBankRequestsInFlight());
+    }
+
+private:
+    struct Entry {
+        uint64_t arrival;
+        int instanceId;
+        size_t requests;             // Bank requests it can have in flight, 0 if compute-bound
+    };
+
+    std::vector<char> memoryBoundTasks;  // Per task index
+    std::vector<uint64_t> taskMemoryOps; // Per task index
+    uint64_t queueDepth;             // Load/store queue entries per thread context
+    MemorySystem* memory;
+    size_t admissionLimit;           // Bank requests in flight that stop memory-bound dispatch
+    std::deque<Entry> memoryQueue;
+    std::deque<Entry> computeQueue;
+    uint64_t arrivals;               // Instances added so far, orders the two queues
+    uint64_t throttled;
+    uint64_t interleaved;
+
+    static size_t limitFor(const MemorySystem* memory, double occupancyThreshold) {
+        if (memory == nullptr) {
+            throw std::invalid_argument("BandwidthAwarePolicy needs a MemorySystem");
+        }
+        return std::max<size_t>(1, static_cast<size_t>(occupancyThreshold * memory->getBankPortCount()));
+    }
+
+    // Whether the oldest ready instance is memory-bound
+    bool memoryFirst() const {
+        return !memoryQueue.empty() &&
+               (computeQueue.empty() || memoryQueue.front().arrival < computeQueue.front().arrival);
+    }
+
+    int pop(bool memoryBound) {
+        std::deque<Entry>& queue = memoryBound ? memoryQueue : computeQueue;
+        int instanceId = queue.front().instanceId;
+        queue.pop_front();
+        return instanceId;
+    }
+};
+
+// One scheduler per built-in policy; Simulator::setup picks the alternative
+using AnyScheduler = std::variant<
+    Scheduler<FifoPolicy>,
+    Scheduler<RoundRobinPolicy>,
+    Scheduler<ShortestOpsFirstPolicy>,
+    Scheduler<CriticalPathPolicy>,
+    Scheduler<AffinityPolicy>,
+    Scheduler<WorkStealingPolicy>,
+    Scheduler<HierarchicalPolicy>,
+    Scheduler<BandwidthAwarePolicy>,
+    Scheduler<EarliestDeadlinePolicy>,
+    Scheduler<EarliestFinishTimePolicy>>;
+
+#endif // SCHEDULINGPOLICIES_HPP
@@ -1,8 +1,23 @@
 #include "Simulator.hpp"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
+#include <utility>
+#include <variant>
 
-Simulator::Simulator() : now(0) {}
+Simulator::Simulator() : now(0), hasDeadlines(false), targetCycles(0), skipped(false), statsPath("stats.json") {}
+
+void Simulator::setTargetCycles(uint64_t cycles) {
+    targetCycles = cycles;
+}
+
+void Simulator::setStatsPath(const std::string& path) {
+    statsPath = path;
+}
+
+bool Simulator::wasSkipped() const {
+    return skipped;
+}
 
 void Simulator::initialize(const std::string& configPath, 
                           const std::string& tasksPath, 
@@ -11,23 +26,90 @@ void Simulator::initialize(const std::string& configPath,
     config = Config::loadFromFile(configPath);
     config.validate();
     
-    // Load and build task graph from CSV files
+    // Load task graph from CSV files
     taskGraph.loadFromCSV(tasksPath, opsPath);
-    taskGraph.buildDAG();
     
-    // Initialize cores array based on config.numCores
-    cores.clear();
-    cores.reserve(config.numCores);
-    for (int i = 0; i < config.numCores; ++i) {
-        cores.emplace_back(i);
+    setup();
+}
+
+void Simulator::initializeFromGraph(const std::string& configPath,
+                                    const std::string& graphPath) {
+    // Load configuration from JSON file
+    config = Config::loadFromFile(configPath);
+    config.validate();
+    
+    // Map the pre-built binary graph
+    taskGraph.loadFromBinary(graphPath);
+    
+    setup();
+}
+
+template <typename Policy, typename... Args>
+void Simulator::makeScheduler(Args&&... policyArgs) {
+    // Policies see each hardware thread context as a core
+    scheduler.emplace(std::in_place_type<Scheduler<Policy>>, config.getContextCount(), &taskGraph,
+                      config.contextToChiplet, std::forward<Args>(policyArgs)...);
+}
+
+void Simulator::setup() {
+    // Initialize statistics collector
+    statsCollector = std::make_unique<StatsCollector>(config.numCores, config.threadContexts);
+    
+    // Static bounds are cheap compared to simulation; compute them first
+    GraphBounds bounds = GraphAnalysis(config).analyze(taskGraph);
+    statsCollector->setBounds(bounds);
+    std::cout << "Makespan lower bound: " << bounds.lowerBound << " cycles (critical path "
+              << bounds.criticalPath << ", work bound " << bounds.workBound << ")" << std::endl;
+    
+    if (targetCycles > 0 && bounds.lowerBound > targetCycles) {
+        skipped = true;
+        return;
     }
     
-    // Initialize scheduler with policy and task graph
-    scheduler = std::make_unique<Scheduler>(
-        config.schedulingPolicy, 
-        config.numCores, 
-        &taskGraph
-    );
+    // Build task instances and dependencies
+    taskGraph.buildDAG(config.instanceMaterialization);
+    hasDeadlines = false;
+    for (const Task& task : taskGraph.getTasks()) {
+        hasDeadlines = hasDeadlines || task.deadline > 0;
+    }
+    
+    // Every task must run on some core class, and on every class unless the
+    // policy places instances by capability; hints name configured classes
+    if (!config.coreClasses.empty()) {
+        for (const Task& task : taskGraph.getTasks()) {
+            if (!task.coreClass.empty() && config.findCoreClass(task.coreClass) == -1) {
+                throw std::runtime_error("Task " + std::to_string(task.id) + " prefers unknown core class " +
+                                         task.coreClass);
+            }
+            uint32_t opTypes = taskGraph.getOpTypes(task.id);
+            bool runsSomewhere = false;
+            for (const CoreClass& coreClass : config.coreClasses) {
+                bool capable = (opTypes & ~coreClass.opTypes) == 0;
+                runsSomewhere = runsSomewhere || capable;
+                if (!capable && config.schedulingPolicy != SchedulingPolicy::EarliestFinishTime) {
+                    throw std::runtime_error("Task " + std::to_string(task.id) + " cannot run on core class " +
+                                             coreClass.name + "; only the eft policy places tasks by capability");
+                }
+            }
+            if (!runsSomewhere) {
+                throw std::runtime_error("Task " + std::to_string(task.id) + " runs on no core class");
+            }
+        }
+    }
+    
+    // One pipeline per core, shared by the core's thread contexts and
+    // running at the speed of the core's class
+    pipelines.clear();
+    for (int i = 0; i < config.numCores; i++) {
+        const CoreClass* coreClass = config.getCoreClass(i);
+        pipelines.emplace_back(config.contextSwitchCycles,
+                               coreClass != nullptr ? coreClass->computeSpeed : 1.0);
+    }
+    cores.clear();
+    cores.reserve(config.getContextCount());
+    for (int i = 0; i < config.getContextCount(); ++i) {
+        cores.emplace_back(i, config.lsqDepth, &pipelines[config.getContextCore(i)]);
+    }
     
     // Initialize memory system with config parameters
     memorySystem = std::make_unique<MemorySystem>(config);
@@ -35,8 +117,96 @@ void Simulator::initialize(const std::string& configPath,
     // Set up event scheduler callback for memory system
     memorySystem->setEventScheduler(&Simulator::eventSchedulerCallback, this);
     
-    // Initialize statistics collector
-    statsCollector = std::make_unique<StatsCollector>(config.numCores);
+    // Initialize the scheduler of the configured policy; this is the only
+    // place the policy is looked up at run time
+    switch (config.schedulingPolicy) {
+        case SchedulingPolicy::FIFO:
+            makeScheduler<FifoPolicy>();
+            break;
+        case SchedulingPolicy::RoundRobin:
+            makeScheduler<RoundRobinPolicy>();
+            break;
+        case SchedulingPolicy::ShortestOpsFirst:
+            makeScheduler<ShortestOpsFirstPolicy>();
+            break;
+        case SchedulingPolicy::CriticalPath: {
+            std::vector<uint64_t> ranks(bounds.tasks.size());
+            for (size_t t = 0; t < ranks.size(); t++) {
+                ranks[t] = bounds.tasks[t].instanceRank;
+            }
+            makeScheduler<CriticalPathPolicy>(std::move(ranks));
+            break;
+        }
+        case SchedulingPolicy::Affinity:
+            affinity = std::make_unique<ChipletAffinity>(config, taskGraph);
+            makeScheduler<AffinityPolicy>(affinity.get());
+            break;
+        case SchedulingPolicy::WorkStealing:
+            makeScheduler<WorkStealingPolicy>(config.stealVictim, config.stealLatency,
+                                              config.remoteChipletPenalty, config.stealSeed);
+            break;
+        case SchedulingPolicy::Hierarchical:
+            makeScheduler<HierarchicalPolicy>(config.dispatchLatency, config.dispatchInterval,
+                                              config.migrationCost);
+            break;
+        case SchedulingPolicy::BandwidthAware: {
+            // Memory ops per cycle of the instance's lower-bound duration
+            std::vector<char> memoryBound(bounds.tasks.size());
+            std::vector<uint64_t> memoryOps(bounds.tasks.size());
+            for (size_t t = 0; t < memoryBound.size(); t++) {
+                const TaskBound& task = bounds.tasks[t];
+                memoryBound[t] = task.cost > 0 &&
+                    static_cast<double>(task.memoryOps) / task.cost >= config.memoryIntensity;
+                memoryOps[t] = task.memoryOps;
+            }
+            memorySystem->setOccupancyTracking(true);
+            makeScheduler<BandwidthAwarePolicy>(std::move(memoryBound), std::move(memoryOps), config.lsqDepth,
+                                                memorySystem.get(), config.occupancyThreshold);
+            break;
+        }
+        case SchedulingPolicy::EarliestDeadline:
+            makeScheduler<EarliestDeadlinePolicy>();
+            break;
+        case SchedulingPolicy::EarliestFinishTime: {
+            // Ranks as for critical_path, and instance costs on each core
+            // class; without classes all cores form one
+            const std::vector<Task>& tasks = taskGraph.getTasks();
+            std::vector<uint64_t> ranks(tasks.size());
+            for (size_t t = 0; t < ranks.size(); t++) {
+                ranks[t] = bounds.tasks[t].instanceRank;
+            }
+            size_t numClasses = std::max<size_t>(config.coreClasses.size(), 1);
+            std::vector<uint64_t> costs(tasks.size() * numClasses);
+            std::vector<std::string> names;
+            for (size_t k = 0; k < numClasses; k++) {
+                const CoreClass* coreClass = config.coreClasses.empty() ? nullptr : &config.coreClasses[k];
+                GraphBounds classBounds = coreClass != nullptr ?
+                    GraphAnalysis(config, static_cast<int>(k)).analyze(taskGraph) : bounds;
+                for (size_t t = 0; t < tasks.size(); t++) {
+                    bool capable = coreClass == nullptr ||
+                                   (taskGraph.getOpTypes(tasks[t].id) & ~coreClass->opTypes) == 0;
+                    costs[t * numClasses + k] = capable ? classBounds.tasks[t].cost
+                                                        : EarliestFinishTimePolicy::kIneligible;
+                }
+                names.push_back(coreClass != nullptr ? coreClass->name : "all");
+            }
+            std::vector<int> hints(tasks.size(), -1);
+            std::vector<int> contextClass(config.getContextCount(), 0);
+            if (!config.coreClasses.empty()) {
+                for (size_t t = 0; t < tasks.size(); t++) {
+                    hints[t] = config.findCoreClass(tasks[t].coreClass);
+                }
+                for (int c = 0; c < config.getContextCount(); c++) {
+                    contextClass[c] = config.coreToClass[config.getContextCore(c)];
+                }
+            }
+            makeScheduler<EarliestFinishTimePolicy>(std::move(contextClass), std::move(ranks), std::move(costs),
+                                                    std::move(hints), std::move(names));
+            break;
+        }
+        default:
+            throw std::runtime_error("Unknown scheduling policy");
+    }
     
     // Seed initial TaskReady events for instances with inDegree == 0
     std::vector<int> readyInstances = taskGraph.getReadyInstances();
@@ -44,9 +214,38 @@ void Simulator::initialize(const std::string& configPath,
         Event e(EventType::TaskReady, 0, -1, instanceId);
         scheduleEvent(e);
     }
+    materializeReadyInstances();
+    
+    std::cout << "Simulator initialized with " << config.numCores << " cores";
+    if (config.threadContexts > 1) {
+        std::cout << " (" << config.threadContexts << " thread contexts each)";
+    }
+    std::cout << ", " << taskGraph.getTotalInstanceCount() << " task instances" << std::endl;
     
-    std::cout << "Simulator initialized with " << config.numCores << " cores, "
-              << taskGraph.getInstances().size() << " task instances" << std::endl;
+    const InstanceTable& instances = taskGraph.getInstances();
+    if (instances.edgeCount() > 0) {
+        std::cout << "Instance edges: " << instances.edgeCount() << " ("
+                  << instances.edgeBytes() / 1024 << " KiB as CSR, ~"
+                  << instances.nestedEdgeBytes() / 1024 << " KiB as per-instance vectors)"
+                  << std::endl;
+    }
+}
+
+size_t Simulator::materializeReadyInstances() {
+    // Live instances are the running ones plus at most the ready window
+    size_t limit = static_cast<size_t>(config.getContextCount()) + config.lazyReadyWindow;
+    size_t materialized = 0;
+    
+    while (taskGraph.hasPendingInstances() && taskGraph.getLiveInstanceCount() < limit) {
+        // Carry the releasing core, as eager TaskReady events do, so policies
+        // that queue successors near their producer see the same schedule
+        int releasingCore = -1;
+        int instanceId = taskGraph.materializeInstance(releasingCore);
+        Event readyEvent(EventType::TaskReady, now, releasingCore, instanceId);
+        scheduleEvent(readyEvent);
+        materialized++;
+    }
+    return materialized;
 }
 
 uint64_t Simulator::getCurrentTime() const {
@@ -62,9 +261,8 @@ void Simulator::eventSchedulerCallback(Event event, void* context) {
     sim->scheduleEvent(event);
 }
 
-void Simulator::run() {
-    std::cout << "Starting simulation..." << std::endl;
-    
+template <typename Sched>
+void Simulator::runEvents(Sched& sched) {
     // Main event loop - process events until queue is empty
     while (!eventQueue.empty()) {
         // Pop next event and advance time to event.time
@@ -74,7 +272,7 @@ void Simulator::run() {
         // Dispatch event to appropriate handler based on EventType
         switch (e.type) {
             case EventType::TaskReady:
-                handleTaskReady(e);
+                handleTaskReady(sched, e);
                 break;
             case EventType::TaskDispatched:
                 handleTaskDispatched(e);
@@ -89,7 +287,7 @@ void Simulator::run() {
                 handleMemRespDone(e);
                 break;
             case EventType::TaskDone:
-                handleTaskDone(e);
+                handleTaskDone(sched, e);
                 break;
             default:
                 // Other event types (CacheHit, CacheMiss, BankGrant) are internal
@@ -100,37 +298,73 @@ void Simulator::run() {
         // Notify StatsCollector of each event
         statsCollector->onEvent(e, now);
     }
+}
+
+void Simulator::run() {
+    if (skipped) {
+        std::cout << "Skipping simulation: lower bound exceeds target of "
+                  << targetCycles << " cycles" << std::endl;
+        statsCollector->setSkipped();
+        statsCollector->writeJSON(statsPath, config.frequencyGHz);
+        return;
+    }
+    
+    std::cout << "Starting simulation..." << std::endl;
+    
+    // Enter the event loop compiled for the configured scheduler
+    std::visit([this](auto& sched) { runEvents(sched); }, *scheduler);
     
     std::cout << "Simulation complete at cycle " << now << std::endl;
+    if (config.instanceMaterialization == InstanceMaterialization::Lazy) {
+        std::cout << "Peak live task instances: " << taskGraph.getPeakLiveInstanceCount() << std::endl;
+    }
     
     // Set total cycles in StatsCollector to final now value
     statsCollector->setTotalCycles(now);
+    statsCollector->recordBankTraffic(memorySystem->getLocalBankAccesses(),
+                                      memorySystem->getRemoteBankAccesses());
+    std::vector<uint64_t> pipelineBusy;
+    std::vector<uint64_t> pipelineSwitching;
+    std::vector<uint64_t> contextBusy;
+    for (const Pipeline& pipeline : pipelines) {
+        pipelineBusy.push_back(pipeline.busyCycles);
+        pipelineSwitching.push_back(pipeline.switchingCycles);
+    }
+    for (const Core& context : cores) {
+        contextBusy.push_back(context.getBusyCycles());
+    }
+    statsCollector->recordCoreActivity(pipelineBusy, pipelineSwitching, contextBusy);
+    std::visit([this](const auto& sched) { sched.recordStats(*statsCollector); }, *scheduler);
     
     // Generate and output statistics
     statsCollector->generateReport(config.frequencyGHz);
-    statsCollector->writeJSON("stats.json", config.frequencyGHz);
-}
-
-void Simulator::handleTaskReady(const Event& e) {
-    // Add task instance to scheduler's ready queue
-    scheduler->addReady(e.taskInstanceId);
-    
-    // Record ready time in stats
-    statsCollector->recordTaskReady(e.taskInstanceId, now);
-    
-    // Try to dispatch if there's an idle core
-    if (scheduler->hasReadyInstances()) {
-        int coreId = scheduler->selectIdleCore();
-        if (coreId != -1) {
-            int instanceId = scheduler->selectNextInstance();
-            if (instanceId != -1) {
-                scheduler->dispatch(instanceId, coreId, now);
-                
-                // Schedule TaskDispatched event
-                Event dispatchEvent(EventType::TaskDispatched, now, coreId, instanceId);
-                scheduleEvent(dispatchEvent);
-            }
-        }
+    statsCollector->writeJSON(statsPath, config.frequencyGHz);
+}
+
+template <typename Sched>
+void Simulator::handleTaskReady(Sched& sched, const Event& e) {
+    // Add task instance to scheduler's ready queue; the event's core is the
+    // one whose completion released the instance
+    sched.addReady(e.taskInstanceId, e.coreId);
+    
+    // Record ready time in stats (lazily created instances may have become
+    // ready before their record existed)
+    statsCollector->recordTaskReady(e.taskInstanceId, taskGraph.getInstances().readyTime(e.taskInstanceId));
+    
+    dispatchReadyInstances(sched);
+}
+
+template <typename Sched>
+void Simulator::dispatchReadyInstances(Sched& sched) {
+    // Dispatch to whichever cores are idle and schedule TaskDispatched events
+    // at each instance's dispatch time (later than now after a steal)
+    dispatched.clear();
+    sched.dispatchToIdleCores(now, dispatched);
+    const InstanceTable& instances = taskGraph.getInstances();
+    for (const auto& assignment : dispatched) {
+        Event dispatchEvent(EventType::TaskDispatched, instances.dispatchTime(assignment.first),
+                            assignment.second, assignment.first);
+        scheduleEvent(dispatchEvent);
     }
 }
 
@@ -138,15 +372,8 @@ void Simulator::handleTaskDispatched(const Event& e) {
     // Record dispatch time in stats
     statsCollector->recordTaskDispatched(e.taskInstanceId, now);
     
-    // Get the task instance and its current operation
-    TaskInstance& instance = taskGraph.getInstance(e.taskInstanceId);
-    const std::vector<Op>& ops = taskGraph.getOps(instance.taskId);
-    
     // Core executes the first operation
-    if (instance.currentOpIndex < static_cast<int>(ops.size())) {
-        const Op& op = ops[instance.currentOpIndex];
-        cores[e.coreId].executeOp(op, e.taskInstanceId, now, eventQueue, taskGraph);
-    }
+    cores[e.coreId].startInstance(e.taskInstanceId, now, eventQueue, taskGraph);
 }
 
 void Simulator::handleComputeDone(const Event& e) {
@@ -155,46 +382,63 @@ void Simulator::handleComputeDone(const Event& e) {
 }
 
 void Simulator::handleMemReqIssued(const Event& e) {
-    // Issue memory request to memory system
-    TaskInstance& instance = taskGraph.getInstance(e.taskInstanceId);
-    const std::vector<Op>& ops = taskGraph.getOps(instance.taskId);
-    const Op& op = ops[instance.currentOpIndex];
-    
-    memorySystem->issueRequest(e.address, op.rw, e.coreId, e.taskInstanceId, now);
+    // Issue memory request to memory system; the core put the access type in context
+    AccessType rw = static_cast<AccessType>(e.context);
+    memorySystem->issueRequest(e.address, rw, e.coreId, e.taskInstanceId, now);
 }
 
 void Simulator::handleMemRespDone(const Event& e) {
-    // Memory response received, core completes the memory operation
-    cores[e.coreId].completeOp(now, eventQueue, taskGraph);
+    // Memory response received; context holds the access type of the request
+    AccessType rw = static_cast<AccessType>(e.context);
+    cores[e.coreId].completeMemoryOp(rw, now, eventQueue, taskGraph);
 }
 
-void Simulator::handleTaskDone(const Event& e) {
-    // Record task completion time
+template <typename Sched>
+void Simulator::handleTaskDone(Sched& sched, const Event& e) {
+    // Record task completion time (folds the instance's stats)
     statsCollector->recordTaskDone(e.taskInstanceId, now);
     
+    // Check the instance against its task's deadline, if any
+    if (hasDeadlines) {
+        const InstanceTable& instances = taskGraph.getInstances();
+        const Task& task = taskGraph.getTasks()[taskGraph.getTaskIndex(instances.taskId(e.taskInstanceId))];
+        if (task.deadline > 0) {
+            statsCollector->recordDeadline(task.id, task.deadline, now - instances.readyTime(e.taskInstanceId));
+        }
+    }
+    
     // Mark instance as complete and get newly ready successors
-    taskGraph.markInstanceComplete(e.taskInstanceId);
+    newlyReady.clear();
+    taskGraph.markInstanceComplete(e.taskInstanceId, now, e.coreId, newlyReady);
     
     // Release the core
-    scheduler->releaseCore(e.coreId);
+    sched.releaseCore(e.coreId);
     
     // Schedule TaskReady events for newly ready successors
-    std::vector<int> readyInstances = taskGraph.getReadyInstances();
-    for (int instanceId : readyInstances) {
-        TaskInstance& inst = taskGraph.getInstance(instanceId);
-        // Only schedule if this instance just became ready (inDegree was just decremented to 0)
-        if (inst.inDegree == 0 && inst.readyTime == 0) {
-            inst.readyTime = now;
-            Event readyEvent(EventType::TaskReady, now, -1, instanceId);
-            scheduleEvent(readyEvent);
+    for (int instanceId : newlyReady) {
+        Event readyEvent(EventType::TaskReady, now, e.coreId, instanceId);
+        scheduleEvent(readyEvent);
+    }
+    
+    // The record is no longer needed; lazy mode recycles it for a ready instance
+    taskGraph.releaseInstance(e.taskInstanceId);
+    size_t materialized = materializeReadyInstances();
+    
+    if constexpr (!Sched::kDispatchOnCompletion) {
+        // Successors reach this core's deque (or chiplet queue) with their
+        // TaskReady events, which dispatch them at their modeled cost;
+        // without successors the core looks for work now
+        if (newlyReady.empty() && materialized == 0) {
+            dispatchReadyInstances(sched);
         }
+        return;
     }
     
     // Try to dispatch another task to this now-idle core
-    if (scheduler->hasReadyInstances()) {
-        int instanceId = scheduler->selectNextInstance();
+    if (sched.hasReadyInstances()) {
+        int instanceId = sched.selectInstanceForCore(e.coreId);
         if (instanceId != -1) {
-            scheduler->dispatch(instanceId, e.coreId, now);
+            sched.dispatch(instanceId, e.coreId, now);
             
             // Schedule TaskDispatched event
             Event dispatchEvent(EventType::TaskDispatched, now, e.coreId, instanceId);
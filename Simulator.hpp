@@ -5,12 +5,14 @@
 #include "EventQueue.hpp"
 #include "Config.hpp"
 #include "TaskGraph.hpp"
-#include "Scheduler.hpp"
+#include "SchedulingPolicies.hpp"
 #include "Core.hpp"
 #include "MemorySystem.hpp"
 #include "StatsCollector.hpp"
+#include "GraphAnalysis.hpp"
 #include <vector>
 #include <memory>
+#include <optional>
 #include <string>
 #include <cstdint>
 
@@ -27,10 +29,28 @@ private:
     EventQueue eventQueue;
     Config config;
     TaskGraph taskGraph;
-    std::unique_ptr<Scheduler> scheduler;
-    std::vector<Core> cores;
+    std::optional<AnyScheduler> scheduler;      // Instantiated for the configured policy
+    std::unique_ptr<ChipletAffinity> affinity;  // Home chiplets under the affinity policy
+    std::vector<Core> cores;                    // One per hardware thread context
+    std::vector<Pipeline> pipelines;            // One per core
     std::unique_ptr<MemorySystem> memorySystem;
     std::unique_ptr<StatsCollector> statsCollector;
+    
+    // Scratch list of instances released by the last completion
+    std::vector<int> newlyReady;
+    
+    // Scratch list of (instance, core) pairs dispatched by the last ready event
+    std::vector<std::pair<int, int>> dispatched;
+    
+    // Whether any task has a deadline to check completions against
+    bool hasDeadlines;
+    
+    // Makespan target; runs whose lower bound exceeds it are not simulated
+    uint64_t targetCycles;
+    bool skipped;
+    
+    // Where run() writes the statistics JSON
+    std::string statsPath;
 
 public:
     /**
@@ -38,6 +58,18 @@ public:
      */
     Simulator();
     
+    /**
+     * Skip simulation when the static lower bound already exceeds a target
+     * @param cycles Target makespan in cycles (0 disables the check)
+     */
+    void setTargetCycles(uint64_t cycles);
+    
+    /**
+     * Set the file run() writes statistics to
+     * @param path Output JSON path (default stats.json in the working directory)
+     */
+    void setStatsPath(const std::string& path);
+    
     /**
      * Initialize the simulator with configuration and task files
      * @param configPath Path to configuration JSON file
@@ -48,6 +80,14 @@ public:
                    const std::string& tasksPath, 
                    const std::string& opsPath);
     
+    /**
+     * Initialize the simulator with configuration and a binary graph file
+     * @param configPath Path to configuration JSON file
+     * @param graphPath Path to graph file produced by csv2graph
+     */
+    void initializeFromGraph(const std::string& configPath,
+                             const std::string& graphPath);
+    
     /**
      * Run the simulation until completion
      */
@@ -58,19 +98,46 @@ public:
      * @return Current time in cycles
      */
     uint64_t getCurrentTime() const;
+    
+    /**
+     * Check whether the run was skipped because of the target makespan
+     * @return True if the lower bound exceeded the target
+     */
+    bool wasSkipped() const;
 
 private:
+    // Build the DAG and set up cores, scheduler and memory once the graph is loaded
+    void setup();
+    
+    // Construct the scheduler of one policy
+    template <typename Policy, typename... Args>
+    void makeScheduler(Args&&... policyArgs);
+    
+    // Main event loop, compiled once per scheduler type
+    template <typename Sched>
+    void runEvents(Sched& sched);
+    
     // Event handlers
-    void handleTaskReady(const Event& e);
+    template <typename Sched>
+    void handleTaskReady(Sched& sched, const Event& e);
     void handleTaskDispatched(const Event& e);
     void handleComputeDone(const Event& e);
     void handleMemReqIssued(const Event& e);
     void handleMemRespDone(const Event& e);
-    void handleTaskDone(const Event& e);
+    template <typename Sched>
+    void handleTaskDone(Sched& sched, const Event& e);
+    
+    // Pair ready instances with idle cores and schedule their TaskDispatched events
+    template <typename Sched>
+    void dispatchReadyInstances(Sched& sched);
     
     // Helper method to schedule events
     void scheduleEvent(const Event& e);
     
+    // Create ready instances in lazy mode until the ready window is full;
+    // returns how many TaskReady events were scheduled
+    size_t materializeReadyInstances();
+    
     // Static callback for MemorySystem to schedule events
     static void eventSchedulerCallback(Event event, void* context);
 };
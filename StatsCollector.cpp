@@ -4,25 +4,42 @@
 #include <iomanip>
 #include <numeric>
 #include <algorithm>
+#include <cmath>
 
 // Constructor
-StatsCollector::StatsCollector(int cores)
+StatsCollector::StatsCollector(int cores, int contextsPerCore)
     : totalCycles(0),
       numCores(cores),
       coreBusyCycles(cores, 0),
       coreLastBusyStart(cores, 0),
+      threadContexts(contextsPerCore),
+      coreSwitchCycles(cores, 0),
+      contextBusyCycles(static_cast<size_t>(cores) * contextsPerCore, 0),
       dtcmHits(0),
       cacheHits(0),
       cacheMisses(0),
       mainMemAccesses(0),
       interconnectBusyCycles(0),
       interconnectLastBusyStart(0),
+      localBankAccesses(0),
+      remoteBankAccesses(0),
+      haveStealing(false),
+      localDispatches(0),
+      steals(0),
+      remoteSteals(0),
+      haveAdmission(false),
+      throttledDispatches(0),
+      interleavedDispatches(0),
+      peakBankRequestsInFlight(0),
+      heldBackDispatches(0),
       bankConflicts(0),
       cachePortConflicts(0),
       bankPortConflicts(0),
       intraChipletConflicts(0),
       interChipletConflicts(0),
-      currentTime(0) {
+      currentTime(0),
+      haveBounds(false),
+      simulated(true) {
 }
 
 // Event notification dispatcher
@@ -31,13 +48,10 @@ void StatsCollector::onEvent(const Event& e, uint64_t now) {
     
     switch (e.type) {
         case EventType::TaskReady:
-            recordTaskReady(e.taskInstanceId, now);
-            break;
         case EventType::TaskDispatched:
-            recordTaskDispatched(e.taskInstanceId, now);
-            break;
         case EventType::TaskDone:
-            recordTaskDone(e.taskInstanceId, now);
+            // Task timing is recorded by the Simulator's handlers, which run
+            // before instance records are recycled
             break;
         case EventType::ComputeDone:
         case EventType::MemRespDone:
@@ -73,6 +87,10 @@ void StatsCollector::recordTaskDone(int instanceId, uint64_t time) {
     if (readyIt != taskReadyTimes.end()) {
         uint64_t latency = time - readyIt->second;
         taskLatencies.push_back(latency);
+        
+        // Timing is folded; the instance id may be reused
+        taskReadyTimes.erase(readyIt);
+        taskDispatchTimes.erase(instanceId);
     }
 }
 
@@ -91,6 +109,21 @@ void StatsCollector::recordCoreIdle(int coreId, uint64_t endTime) {
     }
 }
 
+// Set pipeline and context activity accumulated by the cores
+void StatsCollector::recordCoreActivity(const std::vector<uint64_t>& pipelineBusy,
+                                        const std::vector<uint64_t>& pipelineSwitching,
+                                        const std::vector<uint64_t>& contextBusy) {
+    if (pipelineBusy.size() == coreBusyCycles.size()) {
+        coreBusyCycles = pipelineBusy;
+    }
+    if (pipelineSwitching.size() == coreSwitchCycles.size()) {
+        coreSwitchCycles = pipelineSwitching;
+    }
+    if (contextBusy.size() == contextBusyCycles.size()) {
+        contextBusyCycles = contextBusy;
+    }
+}
+
 // Record memory access by tier
 void StatsCollector::recordMemoryAccess(MemoryTier tier) {
     switch (tier) {
@@ -140,11 +173,84 @@ void StatsCollector::recordInterconnectIdle(uint64_t endTime) {
     interconnectBusyCycles += busyDuration;
 }
 
+// Set bank traffic totals
+void StatsCollector::recordBankTraffic(uint64_t local, uint64_t remote) {
+    localBankAccesses = local;
+    remoteBankAccesses = remote;
+}
+
+// Set work-stealing totals
+void StatsCollector::recordWorkStealing(uint64_t local, uint64_t stolen, uint64_t remoteStolen) {
+    haveStealing = true;
+    localDispatches = local;
+    steals = stolen;
+    remoteSteals = remoteStolen;
+}
+
+// Set bandwidth-aware admission totals
+void StatsCollector::recordAdmission(uint64_t throttled, uint64_t interleaved, uint64_t peakInFlight) {
+    haveAdmission = true;
+    throttledDispatches = throttled;
+    interleavedDispatches = interleaved;
+    peakBankRequestsInFlight = peakInFlight;
+}
+
+// Set earliest-finish-time placement totals
+void StatsCollector::recordClassPlacement(const std::vector<std::string>& classNames,
+                                          const std::vector<uint64_t>& dispatches, uint64_t heldBack) {
+    coreClassNames = classNames;
+    coreClassDispatches = dispatches;
+    heldBackDispatches = heldBack;
+}
+
+// Record the outcome of an instance with a deadline
+void StatsCollector::recordDeadline(int taskId, uint64_t deadline, uint64_t latency) {
+    DeadlineStats& stats = deadlineStats[taskId];
+    stats.deadline = deadline;
+    int64_t lateness = static_cast<int64_t>(latency) - static_cast<int64_t>(deadline);
+    stats.lateness.push_back(lateness);
+    if (lateness > 0) {
+        stats.misses++;
+    }
+}
+
+uint64_t StatsCollector::getDeadlineMisses() const {
+    uint64_t misses = 0;
+    for (const auto& entry : deadlineStats) {
+        misses += entry.second.misses;
+    }
+    return misses;
+}
+
+// Nearest-rank percentile of sorted samples
+static int64_t percentile(const std::vector<int64_t>& sorted, double fraction) {
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Set hierarchical scheduler loads
+void StatsCollector::recordSchedulerLoads(const std::vector<SchedulerLoad>& chiplets,
+                                          const SchedulerLoad& balancer) {
+    chipletSchedulerLoads = chiplets;
+    balancerLoad = balancer;
+}
+
 // Set total simulation time
 void StatsCollector::setTotalCycles(uint64_t cycles) {
     totalCycles = cycles;
 }
 
+// Set static makespan bounds
+void StatsCollector::setBounds(const GraphBounds& graphBounds) {
+    bounds = graphBounds;
+    haveBounds = true;
+}
+
+// Mark the run as skipped
+void StatsCollector::setSkipped() {
+    simulated = false;
+}
+
 // Generate console report
 void StatsCollector::generateReport(double frequencyGHz) const {
     std::cout << "\n========================================\n";
@@ -158,6 +264,22 @@ void StatsCollector::generateReport(double frequencyGHz) const {
     std::cout << "  Time (seconds): " << std::scientific << std::setprecision(6) 
               << makespanSeconds << "\n\n";
     
+    // Static bounds
+    if (haveBounds) {
+        size_t criticalTasks = std::count_if(bounds.tasks.begin(), bounds.tasks.end(),
+                                             [](const TaskBound& tb) { return tb.slack == 0; });
+        std::cout << "Makespan Bounds:\n";
+        std::cout << "  Critical Path: " << bounds.criticalPath << " cycles\n";
+        std::cout << "  Work Bound: " << bounds.workBound << " cycles\n";
+        std::cout << "  Lower Bound: " << bounds.lowerBound << " cycles\n";
+        std::cout << "  Zero-Slack Tasks: " << criticalTasks << " of " << bounds.tasks.size() << "\n";
+        if (bounds.lowerBound > 0 && totalCycles > 0) {
+            std::cout << "  Makespan / Lower Bound: " << std::fixed << std::setprecision(3)
+                      << static_cast<double>(totalCycles) / bounds.lowerBound << "\n";
+        }
+        std::cout << "\n";
+    }
+    
     // Core utilization
     std::cout << "Core Utilization:\n";
     for (int i = 0; i < numCores; i++) {
@@ -175,6 +297,24 @@ void StatsCollector::generateReport(double frequencyGHz) const {
     std::cout << "  Average: " << std::fixed << std::setprecision(2) 
               << avgUtilization << "%\n\n";
     
+    // Thread contexts: how many of each core's contexts had an instance to run
+    if (threadContexts > 1 && totalCycles > 0) {
+        std::cout << "Thread Contexts (" << threadContexts << " per core):\n";
+        for (int i = 0; i < numCores; i++) {
+            std::cout << "  Core " << i << ":";
+            for (int slot = 0; slot < threadContexts; slot++) {
+                uint64_t busy = contextBusyCycles[static_cast<size_t>(slot) * numCores + i];
+                std::cout << (slot == 0 ? " " : ", ") << std::fixed << std::setprecision(2)
+                          << (100.0 * busy) / totalCycles << "%";
+            }
+            std::cout << " (" << coreSwitchCycles[i] << " switch cycles)\n";
+        }
+        uint64_t totalContextBusy = std::accumulate(contextBusyCycles.begin(),
+                                                    contextBusyCycles.end(), 0ULL);
+        std::cout << "  Average: " << std::fixed << std::setprecision(2)
+                  << (100.0 * totalContextBusy) / (contextBusyCycles.size() * totalCycles) << "%\n\n";
+    }
+    
     // Task timing statistics
     std::cout << "Task Statistics:\n";
     std::cout << "  Total Tasks Completed: " << taskLatencies.size() << "\n";
@@ -194,6 +334,31 @@ void StatsCollector::generateReport(double frequencyGHz) const {
     }
     std::cout << "\n";
     
+    // Deadlines: misses and lateness (completion minus deadline) per task
+    if (!deadlineStats.empty()) {
+        uint64_t checked = 0;
+        for (const auto& entry : deadlineStats) {
+            checked += entry.second.lateness.size();
+        }
+        uint64_t misses = getDeadlineMisses();
+        std::cout << "Deadlines:\n";
+        std::cout << "  Missed: " << misses << " of " << checked << " (" << std::fixed
+                  << std::setprecision(2) << (100.0 * misses / checked) << "%)\n";
+        for (const auto& entry : deadlineStats) {
+            const DeadlineStats& stats = entry.second;
+            std::vector<int64_t> sorted(stats.lateness);
+            std::sort(sorted.begin(), sorted.end());
+            double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+            std::cout << "  Task " << entry.first << " (deadline " << stats.deadline << "): "
+                      << stats.misses << " of " << sorted.size() << " missed ("
+                      << std::setprecision(2) << (100.0 * stats.misses / sorted.size())
+                      << "%), lateness mean " << mean << ", p50 " << percentile(sorted, 0.5)
+                      << ", p95 " << percentile(sorted, 0.95) << ", max " << sorted.back()
+                      << " cycles\n";
+        }
+        std::cout << "\n";
+    }
+    
     // Memory hierarchy statistics
     std::cout << "Memory Hierarchy:\n";
     std::cout << "  DTCM Hits: " << dtcmHits << "\n";
@@ -216,7 +381,58 @@ void StatsCollector::generateReport(double frequencyGHz) const {
     std::cout << "Interconnect:\n";
     std::cout << "  Busy Cycles: " << interconnectBusyCycles << "\n";
     std::cout << "  Utilization: " << std::fixed << std::setprecision(2) 
-              << interconnectUtil << "%\n\n";
+              << interconnectUtil << "%\n";
+    std::cout << "  Local Bank Accesses: " << localBankAccesses << "\n";
+    std::cout << "  Remote Bank Accesses: " << remoteBankAccesses << "\n";
+    uint64_t totalBankAccesses = localBankAccesses + remoteBankAccesses;
+    if (totalBankAccesses > 0) {
+        std::cout << "  Inter-Chiplet Traffic: " << std::fixed << std::setprecision(2)
+                  << (100.0 * remoteBankAccesses / totalBankAccesses) << "%\n";
+    }
+    std::cout << "\n";
+    
+    // Work stealing
+    if (haveStealing) {
+        std::cout << "Work Stealing:\n";
+        std::cout << "  Local Dispatches: " << localDispatches << "\n";
+        std::cout << "  Steals: " << steals << "\n";
+        std::cout << "  Remote Steals: " << remoteSteals << "\n\n";
+    }
+    
+    // Bandwidth-aware admission
+    if (haveAdmission) {
+        std::cout << "Bandwidth-Aware Admission:\n";
+        std::cout << "  Throttled Dispatches: " << throttledDispatches << "\n";
+        std::cout << "  Interleaved Dispatches: " << interleavedDispatches << "\n";
+        std::cout << "  Peak Bank Requests In Flight: " << peakBankRequestsInFlight << "\n\n";
+    }
+    
+    // Earliest-finish-time placement
+    if (!coreClassNames.empty()) {
+        std::cout << "Core Classes:\n";
+        for (size_t k = 0; k < coreClassNames.size(); k++) {
+            std::cout << "  " << coreClassNames[k] << ": " << coreClassDispatches[k] << " dispatches\n";
+        }
+        std::cout << "  Held Back: " << heldBackDispatches << "\n\n";
+    }
+    
+    // Hierarchical schedulers: occupancy and delay before each decision
+    if (!chipletSchedulerLoads.empty()) {
+        auto printLoad = [&](const std::string& name, const SchedulerLoad& load) {
+            double occupancy = totalCycles > 0 ? (100.0 * load.busyCycles) / totalCycles : 0.0;
+            double avgDelay = load.dispatches > 0 ?
+                static_cast<double>(load.queueingDelay) / load.dispatches : 0.0;
+            std::cout << "  " << name << ": " << load.dispatches << " dispatches, "
+                      << std::fixed << std::setprecision(2) << occupancy << "% occupancy, "
+                      << avgDelay << " cycles average queueing delay\n";
+        };
+        std::cout << "Schedulers:\n";
+        for (size_t c = 0; c < chipletSchedulerLoads.size(); c++) {
+            printLoad("Chiplet " + std::to_string(c), chipletSchedulerLoads[c]);
+        }
+        printLoad("Balancer", balancerLoad);
+        std::cout << "\n";
+    }
     
     // Conflict statistics
     std::cout << "Conflicts:\n";
@@ -240,6 +456,7 @@ void StatsCollector::writeJSON(const std::string& filepath, double frequencyGHz)
     double makespanSeconds = totalCycles / (frequencyGHz * 1e9);
     
     outFile << "{\n";
+    outFile << "  \"simulated\": " << (simulated ? "true" : "false") << ",\n";
     outFile << "  \"makespan_cycles\": " << totalCycles << ",\n";
     outFile << "  \"makespan_seconds\": " << std::scientific << std::setprecision(9) 
             << makespanSeconds << ",\n";
@@ -270,6 +487,36 @@ void StatsCollector::writeJSON(const std::string& filepath, double frequencyGHz)
     outFile << "  \"avg_core_utilization\": " << std::fixed << std::setprecision(4) 
             << avgUtilization << ",\n";
     
+    // Thread contexts, per core in context order
+    if (threadContexts > 1) {
+        outFile << "  \"thread_contexts\": {\n";
+        outFile << "    \"contexts_per_core\": " << threadContexts << ",\n";
+        outFile << "    \"core_switch_cycles\": [";
+        for (int i = 0; i < numCores; i++) {
+            outFile << coreSwitchCycles[i] << (i < numCores - 1 ? ", " : "");
+        }
+        outFile << "],\n";
+        outFile << "    \"context_utilization\": [";
+        uint64_t totalContextBusy = 0;
+        for (int i = 0; i < numCores; i++) {
+            outFile << "[";
+            for (int slot = 0; slot < threadContexts; slot++) {
+                uint64_t busy = contextBusyCycles[static_cast<size_t>(slot) * numCores + i];
+                totalContextBusy += busy;
+                double utilization = totalCycles > 0 ? static_cast<double>(busy) / totalCycles : 0.0;
+                outFile << std::fixed << std::setprecision(4) << utilization
+                        << (slot < threadContexts - 1 ? ", " : "");
+            }
+            outFile << "]" << (i < numCores - 1 ? ", " : "");
+        }
+        outFile << "],\n";
+        double avgContext = totalCycles > 0 ?
+            static_cast<double>(totalContextBusy) / (contextBusyCycles.size() * totalCycles) : 0.0;
+        outFile << "    \"avg_context_utilization\": " << std::fixed << std::setprecision(4)
+                << avgContext << "\n";
+        outFile << "  },\n";
+    }
+    
     // Task statistics
     outFile << "  \"total_tasks_completed\": " << taskLatencies.size() << ",\n";
     
@@ -283,6 +530,42 @@ void StatsCollector::writeJSON(const std::string& filepath, double frequencyGHz)
     outFile << "  \"avg_task_wait_cycles\": " << std::fixed << std::setprecision(2) 
             << avgWait << ",\n";
     
+    // Deadlines
+    if (!deadlineStats.empty()) {
+        uint64_t checked = 0;
+        for (const auto& entry : deadlineStats) {
+            checked += entry.second.lateness.size();
+        }
+        uint64_t misses = getDeadlineMisses();
+        outFile << "  \"deadlines\": {\n";
+        outFile << "    \"instances\": " << checked << ",\n";
+        outFile << "    \"missed\": " << misses << ",\n";
+        outFile << "    \"miss_ratio\": " << std::fixed << std::setprecision(4)
+                << static_cast<double>(misses) / checked << ",\n";
+        outFile << "    \"tasks\": [";
+        bool first = true;
+        for (const auto& entry : deadlineStats) {
+            const DeadlineStats& stats = entry.second;
+            std::vector<int64_t> sorted(stats.lateness);
+            std::sort(sorted.begin(), sorted.end());
+            double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+            outFile << (first ? "\n" : ",\n");
+            first = false;
+            outFile << "      {\"task_id\": " << entry.first
+                    << ", \"deadline_cycles\": " << stats.deadline
+                    << ", \"instances\": " << sorted.size()
+                    << ", \"missed\": " << stats.misses
+                    << ", \"miss_ratio\": " << std::setprecision(4)
+                    << static_cast<double>(stats.misses) / sorted.size()
+                    << ", \"lateness_cycles\": {\"mean\": " << std::setprecision(2) << mean
+                    << ", \"p50\": " << percentile(sorted, 0.5)
+                    << ", \"p95\": " << percentile(sorted, 0.95)
+                    << ", \"max\": " << sorted.back() << "}}";
+        }
+        outFile << "\n    ]\n";
+        outFile << "  },\n";
+    }
+    
     // Memory accesses
     outFile << "  \"memory_accesses\": {\n";
     outFile << "    \"dtcm_hits\": " << dtcmHits << ",\n";
@@ -297,6 +580,53 @@ void StatsCollector::writeJSON(const std::string& filepath, double frequencyGHz)
     outFile << "  \"interconnect_busy_cycles\": " << interconnectBusyCycles << ",\n";
     outFile << "  \"interconnect_utilization\": " << std::fixed << std::setprecision(4) 
             << interconnectUtil << ",\n";
+    outFile << "  \"local_bank_accesses\": " << localBankAccesses << ",\n";
+    outFile << "  \"remote_bank_accesses\": " << remoteBankAccesses << ",\n";
+    if (haveStealing) {
+        outFile << "  \"work_stealing\": {\n";
+        outFile << "    \"local_dispatches\": " << localDispatches << ",\n";
+        outFile << "    \"steals\": " << steals << ",\n";
+        outFile << "    \"remote_steals\": " << remoteSteals << "\n";
+        outFile << "  },\n";
+    }
+    if (haveAdmission) {
+        outFile << "  \"bandwidth_aware\": {\n";
+        outFile << "    \"throttled_dispatches\": " << throttledDispatches << ",\n";
+        outFile << "    \"interleaved_dispatches\": " << interleavedDispatches << ",\n";
+        outFile << "    \"peak_bank_requests_in_flight\": " << peakBankRequestsInFlight << "\n";
+        outFile << "  },\n";
+    }
+    if (!coreClassNames.empty()) {
+        outFile << "  \"core_classes\": {\n";
+        outFile << "    \"dispatches\": {";
+        for (size_t k = 0; k < coreClassNames.size(); k++) {
+            outFile << (k > 0 ? ", " : "") << "\"" << coreClassNames[k] << "\": " << coreClassDispatches[k];
+        }
+        outFile << "},\n";
+        outFile << "    \"held_back\": " << heldBackDispatches << "\n";
+        outFile << "  },\n";
+    }
+    if (!chipletSchedulerLoads.empty()) {
+        auto writeLoad = [&](const SchedulerLoad& load) {
+            double occupancy = totalCycles > 0 ? static_cast<double>(load.busyCycles) / totalCycles : 0.0;
+            double avgDelay = load.dispatches > 0 ?
+                static_cast<double>(load.queueingDelay) / load.dispatches : 0.0;
+            outFile << "{\"dispatches\": " << load.dispatches
+                    << ", \"busy_cycles\": " << load.busyCycles
+                    << ", \"occupancy\": " << std::fixed << std::setprecision(4) << occupancy
+                    << ", \"avg_queueing_delay_cycles\": " << std::setprecision(2) << avgDelay << "}";
+        };
+        outFile << "  \"schedulers\": {\n";
+        outFile << "    \"chiplets\": [";
+        for (size_t c = 0; c < chipletSchedulerLoads.size(); c++) {
+            outFile << (c > 0 ? ", " : "");
+            writeLoad(chipletSchedulerLoads[c]);
+        }
+        outFile << "],\n";
+        outFile << "    \"balancer\": ";
+        writeLoad(balancerLoad);
+        outFile << "\n  },\n";
+    }
     
     // Conflicts
     outFile << "  \"conflicts\": {\n";
@@ -305,7 +635,35 @@ void StatsCollector::writeJSON(const std::string& filepath, double frequencyGHz)
     outFile << "    \"bank_port_conflicts\": " << bankPortConflicts << ",\n";
     outFile << "    \"intra_chiplet_conflicts\": " << intraChipletConflicts << ",\n";
     outFile << "    \"inter_chiplet_conflicts\": " << interChipletConflicts << "\n";
-    outFile << "  }\n";
+    outFile << "  }";
+    
+    // Static bounds and per-task slack
+    if (haveBounds) {
+        double boundRatio = (bounds.lowerBound > 0 && simulated) ?
+            static_cast<double>(totalCycles) / bounds.lowerBound : 0.0;
+        outFile << ",\n";
+        outFile << "  \"bounds\": {\n";
+        outFile << "    \"critical_path_cycles\": " << bounds.criticalPath << ",\n";
+        outFile << "    \"total_work_cycles\": " << bounds.totalWork << ",\n";
+        outFile << "    \"work_bound_cycles\": " << bounds.workBound << ",\n";
+        outFile << "    \"lower_bound_cycles\": " << bounds.lowerBound << ",\n";
+        outFile << "    \"makespan_to_bound\": " << std::fixed << std::setprecision(4)
+                << boundRatio << "\n";
+        outFile << "  },\n";
+        outFile << "  \"task_bounds\": [";
+        for (size_t i = 0; i < bounds.tasks.size(); i++) {
+            const TaskBound& tb = bounds.tasks[i];
+            outFile << (i == 0 ? "\n" : ",\n");
+            outFile << "    {\"task_id\": " << tb.taskId
+                    << ", \"instance_cost\": " << tb.cost
+                    << ", \"earliest_start\": " << tb.earliestStart
+                    << ", \"upward_rank\": " << tb.upwardRank
+                    << ", \"instance_rank\": " << tb.instanceRank
+                    << ", \"slack\": " << tb.slack << "}";
+        }
+        outFile << (bounds.tasks.empty() ? "]" : "\n  ]");
+    }
+    outFile << "\n";
     
     outFile << "}\n";
     
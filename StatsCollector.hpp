@@ -27,11 +27,18 @@ private:
     // Makespan
     uint64_t totalCycles;
     
-    // Per-core utilization tracking
+    // Per-core utilization tracking; a core is busy while its pipeline
+    // computes or switches between thread contexts
     int numCores;
     std::vector<uint64_t> coreBusyCycles;
     std::vector<uint64_t> coreLastBusyStart;  // Track when core became busy
     
+    // Hardware thread contexts: per core switch cycles, and per context the
+    // cycles spent running an instance (context c runs on core c % numCores)
+    int threadContexts;
+    std::vector<uint64_t> coreSwitchCycles;
+    std::vector<uint64_t> contextBusyCycles;
+    
     // Task timing tracking
     std::map<int, uint64_t> taskReadyTimes;      // instanceId -> ready time
     std::map<int, uint64_t> taskDispatchTimes;   // instanceId -> dispatch time
@@ -48,6 +55,41 @@ private:
     uint64_t interconnectBusyCycles;
     uint64_t interconnectLastBusyStart;
     
+    // Bank accesses within and across chiplets
+    uint64_t localBankAccesses;
+    uint64_t remoteBankAccesses;
+    
+    // Work-stealing dispatches (reported only for that policy)
+    bool haveStealing;
+    uint64_t localDispatches;
+    uint64_t steals;
+    uint64_t remoteSteals;
+    
+    // Bandwidth-aware admission (reported only for that policy)
+    bool haveAdmission;
+    uint64_t throttledDispatches;
+    uint64_t interleavedDispatches;
+    uint64_t peakBankRequestsInFlight;
+    
+    // Earliest-finish-time placement per core class (reported only for that policy)
+    std::vector<std::string> coreClassNames;
+    std::vector<uint64_t> coreClassDispatches;
+    uint64_t heldBackDispatches;
+    
+    // Deadline outcomes per task id with a deadline
+    struct DeadlineStats {
+        uint64_t deadline;               // Relative deadline in cycles
+        uint64_t misses;
+        std::vector<int64_t> lateness;   // Completion minus deadline per instance
+        
+        DeadlineStats() : deadline(0), misses(0) {}
+    };
+    std::map<int, DeadlineStats> deadlineStats;
+    
+    // Hierarchical scheduler loads (empty for other policies)
+    std::vector<SchedulerLoad> chipletSchedulerLoads;
+    SchedulerLoad balancerLoad;
+    
     // Conflict counters
     uint64_t bankConflicts;
     uint64_t cachePortConflicts;
@@ -57,10 +99,15 @@ private:
     
     // Current simulation time (for tracking busy periods)
     uint64_t currentTime;
+    
+    // Static bounds from the graph analysis pass
+    bool haveBounds;
+    bool simulated;
+    GraphBounds bounds;
 
 public:
     // Constructor
-    explicit StatsCollector(int cores);
+    explicit StatsCollector(int cores, int contextsPerCore = 1);
     
     // Event notification handlers
     void onEvent(const Event& e, uint64_t now);
@@ -74,6 +121,16 @@ public:
     void recordCoreBusy(int coreId, uint64_t startTime);
     void recordCoreIdle(int coreId, uint64_t endTime);
     
+    /**
+     * Set per-core pipeline and per-context activity after the run
+     * @param pipelineBusy Cycles each core's pipeline computed or switched contexts
+     * @param pipelineSwitching Of which switching between contexts
+     * @param contextBusy Cycles each thread context ran an instance
+     */
+    void recordCoreActivity(const std::vector<uint64_t>& pipelineBusy,
+                            const std::vector<uint64_t>& pipelineSwitching,
+                            const std::vector<uint64_t>& contextBusy);
+    
     // Memory access tracking
     void recordMemoryAccess(MemoryTier tier);
     
@@ -84,9 +141,47 @@ public:
     void recordInterconnectBusy(uint64_t startTime);
     void recordInterconnectIdle(uint64_t endTime);
     
+    // Set bank access totals by whether they crossed chiplets
+    void recordBankTraffic(uint64_t local, uint64_t remote);
+    
+    // Set work-stealing totals: instances run by the core that released
+    // them, steals, and steals from another chiplet
+    void recordWorkStealing(uint64_t local, uint64_t stolen, uint64_t remoteStolen);
+    
+    // Set bandwidth-aware admission totals: memory-bound dispatches held back
+    // by bank occupancy, compute-bound instances dispatched ahead of older
+    // memory-bound ones, and the most bank requests seen in flight
+    void recordAdmission(uint64_t throttled, uint64_t interleaved, uint64_t peakInFlight);
+    
+    // Set earliest-finish-time placement totals: instances dispatched to each
+    // core class, and instances that waited for a busy class finishing them
+    // sooner while a core able to run them was idle
+    void recordClassPlacement(const std::vector<std::string>& classNames,
+                              const std::vector<uint64_t>& dispatches, uint64_t heldBack);
+    
+    /**
+     * Record an instance of a task with a deadline
+     * @param taskId Task of the instance
+     * @param deadline Relative deadline of the task in cycles
+     * @param latency Cycles from the instance's ready time to its completion
+     */
+    void recordDeadline(int taskId, uint64_t deadline, uint64_t latency);
+    
+    // Instances that completed after their deadline, over all tasks
+    uint64_t getDeadlineMisses() const;
+    
+    // Set the loads of the per-chiplet schedulers and the balancer
+    void recordSchedulerLoads(const std::vector<SchedulerLoad>& chiplets, const SchedulerLoad& balancer);
+    
     // Set total simulation time
     void setTotalCycles(uint64_t cycles);
     
+    // Set static makespan bounds to report next to the simulated makespan
+    void setBounds(const GraphBounds& graphBounds);
+    
+    // Mark the run as skipped (bounds only, no simulated makespan)
+    void setSkipped();
+    
     // Output methods
     void generateReport(double frequencyGHz) const;
     void writeJSON(const std::string& filepath, double frequencyGHz) const;
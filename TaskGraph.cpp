@@ -1,257 +1,1052 @@
 #include "TaskGraph.hpp"
 #include "CSVParser.hpp"
+#include "DecompressStream.hpp"
+#include "GraphFile.hpp"
+#include "Parallel.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+
+// Bytes of ops.csv that justify another parsing worker
+static const size_t kOpsChunkBytes = 1 << 20;
+
+// Column indices of ops.csv
+struct TaskGraph::OpsColumns {
+    int taskId;
+    int seqIdx;
+    int type;
+    int cycles;
+    int address;
+    int rw;
+};
+
+// Rows of one line-aligned slice of ops.csv (or all rows of a compressed
+// file), in file order
+struct TaskGraph::OpsChunk {
+    size_t firstLine = 0;                   // 1-based line number of the first line
+    size_t lineCount = 0;
+    std::vector<int32_t> taskIndices;       // -1 for rows naming an unknown task
+    std::vector<int32_t> seqIdx;
+    std::vector<Op> ops;
+    AddressExprPool exprs;                  // Ids in ops are local to this pool
+    std::map<int, size_t> unknownTasks;     // Row count per unknown task id
+    std::string error;                      // First row error, if any
+};
 
 TaskGraph::TaskGraph() {
 }
 
 void TaskGraph::loadFromCSV(const std::string& tasksPath, const std::string& opsPath) {
-    // Parse tasks.csv
-    auto taskRows = CSVParser::parseCSV(tasksPath);
+    // Drop any previously loaded graph
+    tasks.clear();
+    traces.clear();
+    addressExprs = AddressExprPool();
+    graphFile.reset();
+    mappedOps = nullptr;
+    mappedOpCount = 0;
+    
+    // Parse tasks.csv; a compressed file is small enough to inflate whole
+    MappedFile tasksFile(tasksPath);
+    std::string tasksText;
+    Compression tasksCompression = DecompressStream::detect(tasksFile);
+    if (tasksCompression != Compression::None) {
+        tasksText = DecompressStream(tasksFile, tasksCompression).readAll();
+    }
+    CSVReader taskReader(tasksCompression != Compression::None ? tasksText.data() : tasksFile.data(),
+                         tasksCompression != Compression::None ? tasksText.size() : tasksFile.size(),
+                         tasksPath);
+    int idCol = taskReader.requireColumn("id");
+    int nameCol = taskReader.requireColumn("name");
+    int executionsCol = taskReader.requireColumn("executions");
+    int depsCol = taskReader.requireColumn("deps");
+    int traceCol = taskReader.column("trace");  // Optional
+    int deadlineCol = taskReader.column("deadline");  // Optional
+    int coreClassCol = taskReader.column("core_class");  // Optional
+    std::map<std::string, int> traceIndexByPath;
     
     // Create Task objects
-    for (const auto& row : taskRows) {
+    while (taskReader.next()) {
         Task task;
-        task.id = std::stoi(row.at("id"));
-        task.name = row.at("name");
-        task.executions = std::stoi(row.at("executions"));
+        task.id = taskReader.parseInt<int>(idCol);
+        task.name = std::string(taskReader.field(nameCol));
+        task.executions = taskReader.parseInt<int>(executionsCol);
         
         // Parse dependencies (semicolon-separated)
-        std::string depsStr = row.at("deps");
-        task.dependencies = parseDependencies(depsStr);
+        if (!parseDependencies(taskReader.field(depsCol), task.dependencies)) {
+            throw std::runtime_error(taskReader.fieldError(depsCol, "dependency list"));
+        }
+        
+        // Trace paths are relative to tasks.csv; tasks may share a trace
+        if (traceCol >= 0 && !taskReader.field(traceCol).empty()) {
+            std::filesystem::path tracePath(taskReader.field(traceCol));
+            if (tracePath.is_relative()) {
+                tracePath = std::filesystem::path(tasksPath).parent_path() / tracePath;
+            }
+            auto it = traceIndexByPath.find(tracePath.string());
+            if (it == traceIndexByPath.end()) {
+                it = traceIndexByPath.emplace(tracePath.string(), static_cast<int>(traces.size())).first;
+                traces.push_back(std::make_shared<TraceFile>(tracePath.string()));
+            }
+            task.trace = it->second;
+        }
+        
+        // Relative deadline in cycles; empty or 0 means none
+        if (deadlineCol >= 0 && !taskReader.field(deadlineCol).empty()) {
+            task.deadline = taskReader.parseInt<uint64_t>(deadlineCol);
+        }
+        
+        // Core class hint, checked against the config by the simulator
+        if (coreClassCol >= 0) {
+            task.coreClass = std::string(taskReader.field(coreClassCol));
+        }
         
         tasks.push_back(task);
     }
     
-    // Parse ops.csv
-    auto opsRows = CSVParser::parseCSV(opsPath);
+    // Dense task indices are needed to bucket ops while parsing
+    std::vector<std::string> errors;
+    validateGraph(errors);
     
-    // Group operations by task_id and sort by seq_idx
-    std::map<int, std::vector<std::pair<int, Op>>> taskOpsMap;
+    // Parse ops.csv into per-chunk runs of rows
+    MappedFile opsFile(opsPath);
+    std::vector<OpsChunk> chunks;
+    Compression opsCompression = DecompressStream::detect(opsFile);
+    if (opsCompression != Compression::None) {
+        parseCompressedOps(opsFile, opsCompression, chunks);
+    } else {
+        parseMappedOps(opsFile, chunks);
+    }
+    size_t numChunks = chunks.size();
     
-    for (const auto& row : opsRows) {
-        int taskId = std::stoi(row.at("task_id"));
-        int seqIdx = std::stoi(row.at("seq_idx"));
-        
-        Op op;
-        std::string typeStr = row.at("type");
-        if (typeStr == "compute") {
-            op.type = OpType::Compute;
-            op.cycles = std::stoi(row.at("cycles"));
-            op.address = 0;
-            op.rw = AccessType::Read;  // Default, not used for compute
-        } else if (typeStr == "mem") {
-            op.type = OpType::Memory;
-            op.cycles = 0;
-            
-            // Parse address (hex format)
-            std::string addrStr = row.at("address");
-            if (!addrStr.empty()) {
-                op.address = std::stoull(addrStr, nullptr, 16);
-            } else {
-                op.address = 0;
+    // Row errors are reported for the first bad row in file order
+    for (const auto& chunk : chunks) {
+        if (!chunk.error.empty()) {
+            throw std::runtime_error(chunk.error);
+        }
+    }
+    
+    // Each task's ops form one arena run; chunk k writes its rows of task t
+    // after those of chunks 0..k-1, so runs keep file order
+    size_t numTasks = tasks.size();
+    std::vector<std::vector<uint64_t>> writeOffsets(numChunks, std::vector<uint64_t>(numTasks, 0));
+    for (size_t k = 0; k < numChunks; k++) {
+        for (int32_t t : chunks[k].taskIndices) {
+            if (t >= 0) {
+                writeOffsets[k][t]++;
             }
-            
-            // Parse read/write
-            std::string rwStr = row.at("rw");
-            if (rwStr == "R" || rwStr == "r") {
-                op.rw = AccessType::Read;
-            } else if (rwStr == "W" || rwStr == "w") {
-                op.rw = AccessType::Write;
-            } else {
-                throw std::runtime_error("Invalid rw field: " + rwStr);
+        }
+    }
+    
+    uint64_t totalOps = 0;
+    for (size_t t = 0; t < numTasks; t++) {
+        tasks[t].opBegin = totalOps;
+        for (size_t k = 0; k < numChunks; k++) {
+            uint64_t count = writeOffsets[k][t];
+            writeOffsets[k][t] = totalOps;
+            totalOps += count;
+        }
+        tasks[t].opCount = totalOps - tasks[t].opBegin;
+    }
+    
+    // Chunk expression pools are concatenated; ids shift by each pool's offset
+    std::vector<int> exprOffsets(numChunks);
+    for (size_t k = 0; k < numChunks; k++) {
+        exprOffsets[k] = addressExprs.append(chunks[k].exprs);
+    }
+    
+    opArena.clear();
+    opArena.resize(totalOps);
+    std::vector<int32_t> seqIdx(totalOps);
+    parallelFor(numChunks, 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            const OpsChunk& chunk = chunks[k];
+            std::vector<uint64_t>& cursor = writeOffsets[k];
+            for (size_t r = 0; r < chunk.ops.size(); r++) {
+                int32_t t = chunk.taskIndices[r];
+                if (t < 0) {
+                    continue;
+                }
+                Op op = chunk.ops[r];
+                if (op.type == OpType::Memory && op.addrExpr >= 0) {
+                    op.addrExpr += exprOffsets[k];
+                }
+                uint64_t at = cursor[t]++;
+                opArena[at] = op;
+                seqIdx[at] = chunk.seqIdx[r];
             }
-        } else {
-            throw std::runtime_error("Invalid operation type: " + typeStr);
         }
-        
-        taskOpsMap[taskId].push_back({seqIdx, op});
+    });
+    
+    // Structural problems are collected and reported together
+    std::map<int, size_t> unknownTasks;
+    for (const auto& chunk : chunks) {
+        for (const auto& entry : chunk.unknownTasks) {
+            unknownTasks[entry.first] += entry.second;
+        }
+    }
+    for (const auto& entry : unknownTasks) {
+        errors.push_back(std::to_string(entry.second) + " ops reference unknown task " +
+                         std::to_string(entry.first));
     }
     
-    // Sort operations by seq_idx and assign to tasks
-    for (auto& task : tasks) {
-        if (taskOpsMap.find(task.id) != taskOpsMap.end()) {
-            auto& opsWithIdx = taskOpsMap[task.id];
+    // Order each run by seq_idx, then check and link it
+    std::vector<std::string> taskErrors(numTasks);
+    parallelFor(numTasks, 256, [&](size_t begin, size_t end) {
+        std::vector<std::pair<int32_t, Op>> sorted;
+        for (size_t t = begin; t < end; t++) {
+            const Task& task = tasks[t];
+            int32_t* seq = seqIdx.data() + task.opBegin;
+            Op* ops = opArena.data() + task.opBegin;
+            size_t count = task.opCount;
+            
+            if (task.trace >= 0 && count > 0) {
+                taskErrors[t] = "Task " + std::to_string(task.id) + " has both a trace and ops";
+                continue;
+            }
+            
+            // Ops are usually written in seq_idx order already
+            if (!std::is_sorted(seq, seq + count)) {
+                sorted.clear();
+                for (size_t i = 0; i < count; i++) {
+                    sorted.push_back({seq[i], ops[i]});
+                }
+                std::sort(sorted.begin(), sorted.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+                for (size_t i = 0; i < count; i++) {
+                    seq[i] = sorted[i].first;
+                    ops[i] = sorted[i].second;
+                }
+            }
             
-            // Sort by seq_idx
-            std::sort(opsWithIdx.begin(), opsWithIdx.end(),
-                     [](const auto& a, const auto& b) { return a.first < b.first; });
+            // seq_idx must run 0, 1, 2, ... without gaps or repeats
+            bool sequential = true;
+            for (size_t k = 0; k < count && sequential; k++) {
+                if (seq[k] != static_cast<int32_t>(k)) {
+                    bool duplicate = k > 0 && seq[k] == seq[k - 1];
+                    taskErrors[t] = "Task " + std::to_string(task.id) +
+                                    (duplicate ? ": duplicate seq_idx " + std::to_string(seq[k])
+                                               : ": seq_idx " + std::to_string(seq[k]) +
+                                                 " where " + std::to_string(k) + " was expected");
+                    sequential = false;
+                }
+            }
+            if (!sequential) {
+                continue;
+            }
             
-            // Extract ops
-            for (const auto& pair : opsWithIdx) {
-                task.ops.push_back(pair.second);
+            try {
+                linkRepeatBlocks(task, ops, count, addressExprs);
+            } catch (const std::exception& e) {
+                taskErrors[t] = e.what();
             }
         }
+    });
+    
+    for (auto& error : taskErrors) {
+        if (!error.empty()) {
+            errors.push_back(std::move(error));
+        }
     }
+    
+    throwIfInvalid(errors);
 }
 
-std::vector<int> TaskGraph::parseDependencies(const std::string& depsStr) {
-    std::vector<int> deps;
+void TaskGraph::loadFromBinary(const std::string& graphPath) {
+    auto file = std::make_shared<MappedFile>(graphPath);
+    const char* base = file->data();
+    uint64_t fileSize = file->size();
+    
+    auto fail = [&](const std::string& reason) {
+        throw std::runtime_error("Invalid graph file " + graphPath + ": " + reason);
+    };
+    
+    if (fileSize < sizeof(GraphFileHeader)) {
+        fail("file too small");
+    }
     
-    if (depsStr.empty()) {
-        return deps;
+    GraphFileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    
+    if (std::memcmp(header.magic, kGraphFileMagic, sizeof(header.magic)) != 0) {
+        fail("bad magic");
+    }
+    if (header.version != kGraphFileVersion) {
+        fail("unsupported version " + std::to_string(header.version));
+    }
+    if (header.byteOrderMark != kGraphFileByteOrderMark ||
+        header.opRecordSize != sizeof(Op) || header.exprRecordSize != sizeof(ExprInstr)) {
+        fail("written by an incompatible build");
     }
+    if (header.fileSize != fileSize) {
+        fail("truncated");
+    }
+    
+    // Every section must lie inside the file and be aligned for in-place use
+    auto checkSection = [&](uint64_t offset, uint64_t count, uint64_t recordSize, const char* name) {
+        if (offset % 8 != 0 || offset > fileSize || count > (fileSize - offset) / recordSize) {
+            fail(std::string("bad ") + name + " section");
+        }
+    };
+    checkSection(header.taskOffset, header.taskCount, sizeof(GraphFileTask), "task");
+    checkSection(header.depOffset, header.depCount, sizeof(int32_t), "dependency");
+    checkSection(header.opOffset, header.opCount, sizeof(Op), "op");
+    checkSection(header.exprOffset, header.exprCount, sizeof(ExprInstr), "expression");
+    checkSection(header.stringOffset, header.stringBytes, 1, "string");
     
-    std::stringstream ss(depsStr);
-    std::string token;
+    const auto* fileTasks = reinterpret_cast<const GraphFileTask*>(base + header.taskOffset);
+    const auto* fileDeps = reinterpret_cast<const int32_t*>(base + header.depOffset);
+    const auto* fileExprs = reinterpret_cast<const ExprInstr*>(base + header.exprOffset);
+    const char* strings = base + header.stringOffset;
     
-    while (std::getline(ss, token, ';')) {
-        // Trim whitespace
-        token.erase(0, token.find_first_not_of(" \t\r\n"));
-        token.erase(token.find_last_not_of(" \t\r\n") + 1);
+    // Expressions and ops are used in place, so check them as thoroughly as the CSV parser would
+    AddressExprPool fileExprPool;
+    std::vector<bool> exprStarts;
+    try {
+        AddressExprPool::verify(fileExprs, header.exprCount, exprStarts);
+    } catch (const std::exception& e) {
+        fail(e.what());
+    }
+    fileExprPool.attach(fileExprs, header.exprCount);
+    
+    // The task table is small; copy it. Ops and expressions stay in the mapping.
+    tasks.clear();
+    tasks.reserve(header.taskCount);
+    for (uint64_t t = 0; t < header.taskCount; t++) {
+        const GraphFileTask& rec = fileTasks[t];
+        if (rec.nameOffset > header.stringBytes || rec.nameLength > header.stringBytes - rec.nameOffset ||
+            rec.depBegin > header.depCount || rec.depCount > header.depCount - rec.depBegin ||
+            rec.opBegin > header.opCount || rec.opCount > header.opCount - rec.opBegin ||
+            rec.coreClassOffset > header.stringBytes ||
+            rec.coreClassLength > header.stringBytes - rec.coreClassOffset) {
+            fail("task record " + std::to_string(t) + " out of range");
+        }
         
-        if (!token.empty()) {
-            deps.push_back(std::stoi(token));
+        Task task(rec.id, std::string(strings + rec.nameOffset, rec.nameLength), rec.executions);
+        task.dependencies.assign(fileDeps + rec.depBegin, fileDeps + rec.depBegin + rec.depCount);
+        task.opBegin = rec.opBegin;
+        task.opCount = rec.opCount;
+        task.deadline = rec.deadline;
+        task.coreClass.assign(strings + rec.coreClassOffset, rec.coreClassLength);
+        tasks.push_back(task);
+    }
+    
+    std::vector<std::string> errors;
+    validateGraph(errors);
+    throwIfInvalid(errors);
+    
+    const auto* fileOps = reinterpret_cast<const Op*>(base + header.opOffset);
+    for (const auto& task : tasks) {
+        try {
+            checkMappedOps(task, fileOps + task.opBegin, fileExprPool, exprStarts);
+        } catch (const std::exception& e) {
+            fail(e.what());
         }
     }
     
-    return deps;
+    traces.clear();
+    opArena.clear();
+    opArena.shrink_to_fit();
+    mappedOps = fileOps;
+    mappedOpCount = header.opCount;
+    addressExprs.attach(fileExprs, header.exprCount);
+    graphFile = file;
 }
 
-void TaskGraph::buildDAG() {
-    // Build adjacency list for task-level dependencies
-    adjacencyList.clear();
+void TaskGraph::saveBinary(const std::string& graphPath) const {
+    if (!traces.empty()) {
+        throw std::runtime_error("Graph files cannot store trace-bound tasks: " + graphPath);
+    }
+    std::ofstream out(graphPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open graph file for writing: " + graphPath);
+    }
     
+    // Build the task table, dependency array and string table
+    std::vector<GraphFileTask> fileTasks;
+    std::vector<int32_t> fileDeps;
+    std::string strings;
     for (const auto& task : tasks) {
-        for (int depId : task.dependencies) {
-            adjacencyList[depId].push_back(task.id);
+        GraphFileTask rec = {};
+        rec.id = task.id;
+        rec.executions = task.executions;
+        rec.nameOffset = strings.size();
+        rec.nameLength = static_cast<uint32_t>(task.name.size());
+        rec.depBegin = fileDeps.size();
+        rec.depCount = static_cast<uint32_t>(task.dependencies.size());
+        rec.opBegin = task.opBegin;
+        rec.opCount = task.opCount;
+        rec.deadline = task.deadline;
+        strings += task.name;
+        rec.coreClassOffset = strings.size();
+        rec.coreClassLength = static_cast<uint32_t>(task.coreClass.size());
+        strings += task.coreClass;
+        fileDeps.insert(fileDeps.end(), task.dependencies.begin(), task.dependencies.end());
+        fileTasks.push_back(rec);
+    }
+    
+    GraphFileHeader header = {};
+    std::memcpy(header.magic, kGraphFileMagic, sizeof(header.magic));
+    header.version = kGraphFileVersion;
+    header.byteOrderMark = kGraphFileByteOrderMark;
+    header.opRecordSize = sizeof(Op);
+    header.exprRecordSize = sizeof(ExprInstr);
+    header.taskCount = fileTasks.size();
+    header.depCount = fileDeps.size();
+    header.opCount = getOpCount();
+    header.exprCount = addressExprs.size();
+    header.stringBytes = strings.size();
+    
+    // Lay out 8-byte aligned sections after the header
+    uint64_t offset = sizeof(GraphFileHeader);
+    auto place = [&offset](uint64_t bytes) {
+        offset = (offset + 7) & ~uint64_t(7);
+        uint64_t start = offset;
+        offset += bytes;
+        return start;
+    };
+    header.taskOffset = place(fileTasks.size() * sizeof(GraphFileTask));
+    header.depOffset = place(fileDeps.size() * sizeof(int32_t));
+    header.opOffset = place(header.opCount * sizeof(Op));
+    header.exprOffset = place(header.exprCount * sizeof(ExprInstr));
+    header.stringOffset = place(strings.size());
+    header.fileSize = offset;
+    
+    uint64_t written = 0;
+    auto writeAt = [&](uint64_t at, const void* data, uint64_t bytes) {
+        static const char padding[8] = {};
+        out.write(padding, static_cast<std::streamsize>(at - written));
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        written = at + bytes;
+    };
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.taskOffset, fileTasks.data(), fileTasks.size() * sizeof(GraphFileTask));
+    writeAt(header.depOffset, fileDeps.data(), fileDeps.size() * sizeof(int32_t));
+    writeAt(header.opOffset, opData(), header.opCount * sizeof(Op));
+    writeAt(header.exprOffset, addressExprs.data(), header.exprCount * sizeof(ExprInstr));
+    writeAt(header.stringOffset, strings.data(), strings.size());
+    
+    if (!out) {
+        throw std::runtime_error("Failed to write graph file: " + graphPath);
+    }
+}
+
+TaskGraph::OpsColumns TaskGraph::findOpsColumns(const CSVReader& header) {
+    OpsColumns columns;
+    columns.taskId = header.requireColumn("task_id");
+    columns.seqIdx = header.requireColumn("seq_idx");
+    columns.type = header.requireColumn("type");
+    columns.cycles = header.requireColumn("cycles");
+    columns.address = header.requireColumn("address");
+    columns.rw = header.requireColumn("rw");
+    return columns;
+}
+
+// Split the mapped file into line-aligned chunks, one worker per chunk
+void TaskGraph::parseMappedOps(const MappedFile& opsFile, std::vector<OpsChunk>& chunks) const {
+    CSVReader opsReader(opsFile.data(), opsFile.size(), opsFile.path());
+    OpsColumns columns = findOpsColumns(opsReader);
+    
+    const char* body = opsReader.position();
+    size_t bodyBytes = opsReader.end() - body;
+    size_t numChunks = opsChunkCount > 0 ? opsChunkCount
+                                         : std::min(hardwareThreads(), bodyBytes / kOpsChunkBytes + 1);
+    
+    std::vector<const char*> bounds(numChunks + 1, opsReader.end());
+    bounds[0] = body;
+    for (size_t k = 1; k < numChunks; k++) {
+        const char* at = std::max(bounds[k - 1], body + bodyBytes * k / numChunks);
+        const char* nl = static_cast<const char*>(std::memchr(at, '\n', opsReader.end() - at));
+        bounds[k] = nl != nullptr ? nl + 1 : opsReader.end();
+    }
+    
+    // Line counts give each chunk its first line number for error messages
+    chunks.resize(numChunks);
+    parallelFor(numChunks, 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            chunks[k].lineCount = CSVReader::countLines(bounds[k], bounds[k + 1]);
         }
+    });
+    
+    size_t nextLine = opsReader.lineNumber() + 1;
+    for (size_t k = 0; k < numChunks; k++) {
+        chunks[k].firstLine = nextLine;
+        nextLine += chunks[k].lineCount;
     }
     
-    // Detect cycles
-    detectCycles();
+    parallelFor(numChunks, 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            OpsChunk& chunk = chunks[k];
+            chunk.taskIndices.reserve(chunk.lineCount);
+            chunk.seqIdx.reserve(chunk.lineCount);
+            chunk.ops.reserve(chunk.lineCount);
+            
+            CSVReader reader(opsReader, bounds[k], bounds[k + 1], chunk.firstLine);
+            parseOpsChunk(reader, columns, chunk);
+        }
+    });
+}
+
+// Parse text as the decompression thread produces it, so inflating and
+// parsing overlap and only a few decompressed chunks are alive at a time.
+// All rows go into one OpsChunk, keeping the merge's per-chunk tables small.
+void TaskGraph::parseCompressedOps(const MappedFile& opsFile, Compression format,
+                                   std::vector<OpsChunk>& chunks) const {
+    DecompressStream stream(opsFile, format);
     
-    // Create TaskInstances based on executions count
-    instances.clear();
-    int instanceIdCounter = 0;
+    // The header reader's column names point into the first chunk
+    std::string firstChunk;
+    stream.next(firstChunk);
+    CSVReader opsReader(firstChunk.data(), firstChunk.size(), opsFile.path());
+    OpsColumns columns = findOpsColumns(opsReader);
     
-    // Map from taskId to list of instance IDs for that task
-    std::map<int, std::vector<int>> taskToInstances;
+    chunks.resize(1);
+    OpsChunk& chunk = chunks[0];
+    chunk.firstLine = opsReader.lineNumber() + 1;
     
-    for (const auto& task : tasks) {
-        for (int exec = 0; exec < task.executions; exec++) {
-            TaskInstance instance;
-            instance.instanceId = instanceIdCounter++;
-            instance.taskId = task.id;
-            instance.currentOpIndex = 0;
-            instance.inDegree = 0;  // Will be calculated below
-            instance.readyTime = 0;
-            instance.dispatchTime = 0;
-            instance.doneTime = 0;
+    CSVReader firstRows(opsReader, opsReader.position(), opsReader.end(), chunk.firstLine);
+    parseOpsChunk(firstRows, columns, chunk);
+    chunk.lineCount = CSVReader::countLines(opsReader.position(), opsReader.end());
+    
+    std::string text;
+    while (chunk.error.empty() && stream.next(text)) {
+        CSVReader reader(opsReader, text.data(), text.data() + text.size(), chunk.firstLine + chunk.lineCount);
+        parseOpsChunk(reader, columns, chunk);
+        chunk.lineCount += CSVReader::countLines(text.data(), text.data() + text.size());
+    }
+}
+
+void TaskGraph::parseOpsChunk(CSVReader& reader, const OpsColumns& columns, OpsChunk& chunk) const {
+    // Runs on a worker thread: errors are handed back instead of thrown
+    try {
+        while (reader.next()) {
+            int taskId = reader.parseInt<int32_t>(columns.taskId);
+            int seqIdx = reader.parseInt<int32_t>(columns.seqIdx);
+            
+            Op op;
+            std::string_view typeStr = reader.field(columns.type);
+            if (typeStr == "compute") {
+                op.type = OpType::Compute;
+                op.cycles = reader.parseInt<int>(columns.cycles);
+                op.address = 0;
+                op.rw = AccessType::Read;  // Default, not used for compute
+            } else if (typeStr == "mem") {
+                op.type = OpType::Memory;
+                op.cycles = 0;
+                
+                // Parse address (hex literal or expression)
+                op = parseAddressField(op, reader.field(columns.address), chunk.exprs);
+                
+                // Parse read/write
+                std::string_view rwStr = reader.field(columns.rw);
+                if (rwStr == "R" || rwStr == "r") {
+                    op.rw = AccessType::Read;
+                } else if (rwStr == "W" || rwStr == "w") {
+                    op.rw = AccessType::Write;
+                } else {
+                    throw std::runtime_error("Invalid rw field: " + std::string(rwStr));
+                }
+            } else if (typeStr == "repeat") {
+                // repeat N { ... }: trip count comes from the cycles column
+                op.type = OpType::Repeat;
+                op.cycles = reader.parseInt<int>(columns.cycles);
+                if (op.cycles <= 0) {
+                    throw std::runtime_error("Repeat count must be positive for task " +
+                                             std::to_string(taskId));
+                }
+            } else if (typeStr == "end") {
+                op.type = OpType::EndRepeat;
+            } else if (typeStr == "fence") {
+                op.type = OpType::Fence;
+            } else {
+                throw std::runtime_error("Invalid operation type: " + std::string(typeStr));
+            }
             
-            instances.push_back(instance);
-            taskToInstances[task.id].push_back(instance.instanceId);
+            int taskIndex = getTaskIndex(taskId);
+            if (taskIndex < 0) {
+                chunk.unknownTasks[taskId]++;
+            }
+            chunk.taskIndices.push_back(taskIndex);
+            chunk.seqIdx.push_back(seqIdx);
+            chunk.ops.push_back(op);
+        }
+    } catch (const std::exception& e) {
+        chunk.error = e.what();
+    }
+}
+
+Op TaskGraph::parseAddressField(Op op, std::string_view addrStr, AddressExprPool& exprs) {
+    op.address = 0;
+    op.addrExpr = -1;
+    
+    if (addrStr.empty()) {
+        return op;
+    }
+    
+    // A bare number reads as it would inside an expression: hex with a 0x
+    // prefix, decimal without, so "X" and "X + 0" name the same address
+    bool hex = addrStr.size() > 2 && addrStr[0] == '0' && (addrStr[1] == 'x' || addrStr[1] == 'X');
+    if (hex) {
+        if (CSVReader::parseHexText(addrStr, op.address)) {
+            return op;
+        }
+        if (addrStr.find_first_not_of("0123456789abcdefABCDEFxX") == std::string_view::npos) {
+            throw std::runtime_error("Invalid address: " + std::string(addrStr));
+        }
+    } else {
+        auto result = std::from_chars(addrStr.data(), addrStr.data() + addrStr.size(), op.address);
+        if (result.ec == std::errc() && result.ptr == addrStr.data() + addrStr.size()) {
+            return op;
         }
     }
     
-    // Build instance-level dependencies and calculate in-degrees
-    for (auto& instance : instances) {
-        int taskId = instance.taskId;
+    int exprId = exprs.compile(std::string(addrStr));
+    
+    // Fold expressions without variables into a literal address
+    if (exprs.highestVariable(exprId) < 0) {
+        op.address = exprs.evaluate(exprId, nullptr);
+    } else {
+        op.addrExpr = exprId;
+    }
+    
+    return op;
+}
+
+void TaskGraph::linkRepeatBlocks(const Task& task, Op* ops, size_t count, const AddressExprPool& exprs) {
+    std::vector<int> openRepeats;
+    
+    for (size_t idx = 0; idx < count; idx++) {
+        Op& op = ops[idx];
         
-        // Find the task
-        const Task* task = nullptr;
-        for (const auto& t : tasks) {
-            if (t.id == taskId) {
-                task = &t;
-                break;
+        if (op.type == OpType::Repeat) {
+            if (static_cast<int>(openRepeats.size()) >= kMaxLoopDepth) {
+                throw std::runtime_error("Repeat blocks nested deeper than " +
+                                         std::to_string(kMaxLoopDepth) + " in task " +
+                                         std::to_string(task.id));
+            }
+            openRepeats.push_back(static_cast<int>(idx));
+        } else if (op.type == OpType::EndRepeat) {
+            if (openRepeats.empty()) {
+                throw std::runtime_error("Unmatched 'end' in ops of task " + std::to_string(task.id));
+            }
+            int repeatIdx = openRepeats.back();
+            openRepeats.pop_back();
+            if (repeatIdx + 1 == static_cast<int>(idx)) {
+                throw std::runtime_error("Empty repeat block in ops of task " + std::to_string(task.id));
+            }
+            op.cycles = repeatIdx;
+        } else if (op.type == OpType::Memory && op.addrExpr >= 0) {
+            // Slot 0 is i; slots 1..depth are the counters of enclosing blocks
+            if (exprs.highestVariable(op.addrExpr) > static_cast<int>(openRepeats.size())) {
+                throw std::runtime_error("Address expression in task " + std::to_string(task.id) +
+                                         " uses a loop counter outside its repeat block");
             }
         }
-        
-        if (task == nullptr) {
-            throw std::runtime_error("Task not found for instance");
+    }
+    
+    if (!openRepeats.empty()) {
+        throw std::runtime_error("Unterminated repeat block in ops of task " + std::to_string(task.id));
+    }
+}
+
+// Check a task's mapped ops: known types, addresses naming expressions, and
+// repeat blocks whose EndRepeat ops point back at their own Repeat
+void TaskGraph::checkMappedOps(const Task& task, const Op* ops, const AddressExprPool& exprs,
+                               const std::vector<bool>& exprStarts) {
+    std::string where = " in ops of task " + std::to_string(task.id);
+    for (size_t idx = 0; idx < task.opCount; idx++) {
+        const Op& op = ops[idx];
+        int type = static_cast<int>(op.type);
+        if (type < static_cast<int>(OpType::Compute) || type > static_cast<int>(OpType::Fence)) {
+            throw std::runtime_error("Unknown op type " + std::to_string(type) + where);
         }
+        if (op.type == OpType::Repeat && op.cycles <= 0) {
+            throw std::runtime_error("Repeat count must be positive" + where);
+        }
+        if (op.addrExpr != -1 &&
+            (op.addrExpr < 0 || static_cast<size_t>(op.addrExpr) >= exprStarts.size() ||
+             !exprStarts[op.addrExpr])) {
+            throw std::runtime_error("Invalid address expression " + std::to_string(op.addrExpr) + where);
+        }
+    }
+    
+    // Link a copy the way the CSV loader does and compare the block links
+    std::vector<Op> linked(ops, ops + task.opCount);
+    linkRepeatBlocks(task, linked.data(), linked.size(), exprs);
+    for (size_t idx = 0; idx < task.opCount; idx++) {
+        if (ops[idx].type == OpType::EndRepeat && ops[idx].cycles != linked[idx].cycles) {
+            throw std::runtime_error("'end' at op " + std::to_string(idx) +
+                                     " does not close its own repeat block" + where);
+        }
+    }
+}
+
+bool TaskGraph::parseDependencies(std::string_view depsStr, std::vector<int>& deps) {
+    deps.clear();
+    
+    // Semicolon-separated task ids; blank entries are ignored
+    while (!depsStr.empty()) {
+        size_t sep = depsStr.find(';');
+        std::string_view token = depsStr.substr(0, sep);
+        depsStr = sep == std::string_view::npos ? std::string_view() : depsStr.substr(sep + 1);
         
-        // For each dependency of this task
-        for (int depTaskId : task->dependencies) {
-            // All instances of the dependency task are predecessors
-            const auto& depInstances = taskToInstances[depTaskId];
-            instance.inDegree += depInstances.size();
+        while (!token.empty() && std::isspace(static_cast<unsigned char>(token.front()))) {
+            token.remove_prefix(1);
+        }
+        while (!token.empty() && std::isspace(static_cast<unsigned char>(token.back()))) {
+            token.remove_suffix(1);
+        }
+        if (token.empty()) {
+            continue;
         }
         
-        // Build successor relationships
-        if (adjacencyList.find(taskId) != adjacencyList.end()) {
-            for (int successorTaskId : adjacencyList[taskId]) {
-                // All instances of the successor task are successors
-                const auto& successorInstances = taskToInstances[successorTaskId];
-                for (int successorInstanceId : successorInstances) {
-                    instance.successors.push_back(successorInstanceId);
-                }
-            }
+        int depId = 0;
+        auto result = std::from_chars(token.data(), token.data() + token.size(), depId);
+        if (result.ec != std::errc() || result.ptr != token.data() + token.size()) {
+            return false;
         }
+        deps.push_back(depId);
     }
+    
+    return true;
 }
 
-void TaskGraph::detectCycles() {
-    // Use DFS with three states: 0=unvisited, 1=visiting, 2=visited
-    std::map<int, int> state;
+// Call fn(taskIndex, beginInstance, endInstance) for every instance, splitting
+// the instance range across worker threads. A task's instances may be split
+// between workers.
+template <typename Fn>
+static void forEachInstanceRange(const std::vector<size_t>& firstInstance, Fn fn) {
+    size_t numTasks = firstInstance.size() - 1;
     
-    for (const auto& task : tasks) {
-        state[task.id] = 0;
+    parallelFor(firstInstance[numTasks], 1 << 16, [&](size_t lo, size_t hi) {
+        // Last task starting at or before lo is the one containing it
+        size_t t = std::upper_bound(firstInstance.begin(), firstInstance.end(), lo) -
+                   firstInstance.begin() - 1;
+        for (; t < numTasks && firstInstance[t] < hi; t++) {
+            fn(t, std::max(lo, firstInstance[t]), std::min(hi, firstInstance[t + 1]));
+        }
+    });
+}
+
+void TaskGraph::buildDAG(InstanceMaterialization mode) {
+    // Dependencies were validated and indexed when the graph was loaded
+    size_t numTasks = tasks.size();
+    
+    materialization = mode;
+    instances.clear();
+    freeSlots.clear();
+    readyTasks.clear();
+    pendingPredecessors.clear();
+    liveInstances = 0;
+    peakLiveInstances = 0;
+    
+    if (mode == InstanceMaterialization::Lazy) {
+        // Track readiness per task: every instance of a task depends on every
+        // instance of its predecessor tasks, so one counter per task suffices
+        pendingPredecessors.assign(numTasks, 0);
+        for (size_t t = 0; t < numTasks; t++) {
+            for (int32_t d : getTaskPredecessors(t)) {
+                pendingPredecessors[t] += std::max(tasks[d].executions, 0);
+            }
+            if (pendingPredecessors[t] == 0 && tasks[t].executions > 0) {
+                readyTasks.push_back({tasks[t].id, 0, tasks[t].executions, 0, -1});
+            }
+        }
+        return;
     }
     
-    std::vector<int> path;
+    // Instances of a task get consecutive ids: task t owns the instance range
+    // [firstInstance[t], firstInstance[t + 1])
+    std::vector<size_t> firstInstance(numTasks + 1, 0);
+    for (size_t t = 0; t < numTasks; t++) {
+        firstInstance[t + 1] = firstInstance[t] + std::max(tasks[t].executions, 0);
+    }
+    size_t numInstances = firstInstance[numTasks];
     
-    for (const auto& task : tasks) {
-        if (state[task.id] == 0) {
-            dfsVisit(task.id, state, path);
+    // Every instance depends on every instance of its predecessor tasks, so
+    // in-degree, out-degree and successor ranges are uniform within a task
+    std::vector<uint64_t> outDegree(numTasks, 0);
+    std::vector<int32_t> inDegree(numTasks, 0);
+    for (size_t t = 0; t < numTasks; t++) {
+        for (int32_t s : getTaskSuccessors(t)) {
+            outDegree[t] += firstInstance[s + 1] - firstInstance[s];
+        }
+        for (int32_t d : getTaskPredecessors(t)) {
+            inDegree[t] += static_cast<int32_t>(firstInstance[d + 1] - firstInstance[d]);
+        }
+    }
+    
+    instances.reserve(numInstances);
+    for (size_t t = 0; t < numTasks; t++) {
+        for (int exec = 0; exec < tasks[t].executions; exec++) {
+            instances.add(tasks[t].id, exec, inDegree[t]);
         }
     }
+    liveInstances = numInstances;
+    peakLiveInstances = liveInstances;
+    
+    // Pass 1: per-instance successor counts, then prefix sums into row offsets
+    std::vector<uint64_t> offsets(numInstances + 1, 0);
+    forEachInstanceRange(firstInstance, [&](size_t t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            offsets[i + 1] = outDegree[t];
+        }
+    });
+    for (size_t i = 0; i < numInstances; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    
+    // Pass 2: each worker fills the disjoint target rows of its instances
+    std::vector<int32_t> targets(offsets[numInstances]);
+    forEachInstanceRange(firstInstance, [&](size_t t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            int32_t* out = targets.data() + offsets[i];
+            for (int32_t s : getTaskSuccessors(t)) {
+                for (size_t succ = firstInstance[s]; succ < firstInstance[s + 1]; succ++) {
+                    *out++ = static_cast<int32_t>(succ);
+                }
+            }
+        }
+    });
+    instances.assignSuccessors(std::move(offsets), std::move(targets));
 }
 
-void TaskGraph::dfsVisit(int taskId, std::map<int, int>& state, std::vector<int>& path) {
-    state[taskId] = 1;  // Mark as visiting
-    path.push_back(taskId);
-    
-    // Visit successors
-    if (adjacencyList.find(taskId) != adjacencyList.end()) {
-        for (int successorId : adjacencyList[taskId]) {
-            if (state[successorId] == 1) {
-                // Back edge detected - cycle found
-                std::string cycleStr = "Cycle detected in task dependencies: ";
-                for (int id : path) {
-                    cycleStr += std::to_string(id) + " -> ";
+void TaskGraph::validateGraph(std::vector<std::string>& errors) {
+    size_t numTasks = tasks.size();
+    
+    taskIndexById.clear();
+    taskIndexById.reserve(numTasks);
+    for (size_t t = 0; t < numTasks; t++) {
+        if (!taskIndexById.emplace(tasks[t].id, static_cast<int>(t)).second) {
+            errors.push_back("Duplicate task id " + std::to_string(tasks[t].id));
+        }
+        if (tasks[t].executions < 0) {
+            errors.push_back("Task " + std::to_string(tasks[t].id) + " has negative executions");
+        }
+    }
+    
+    // Predecessor rows straight from the dependency lists; successor row
+    // sizes are counted on the way and filled in a second pass
+    taskPredecessorOffsets.assign(numTasks + 1, 0);
+    taskPredecessors.clear();
+    taskSuccessorOffsets.assign(numTasks + 1, 0);
+    for (size_t t = 0; t < numTasks; t++) {
+        for (int depId : tasks[t].dependencies) {
+            int d = getTaskIndex(depId);
+            if (d < 0) {
+                errors.push_back("Task " + std::to_string(tasks[t].id) +
+                                 " depends on unknown task " + std::to_string(depId));
+                continue;
+            }
+            taskPredecessors.push_back(d);
+            taskSuccessorOffsets[d + 1]++;
+        }
+        taskPredecessorOffsets[t + 1] = taskPredecessors.size();
+    }
+    for (size_t t = 0; t < numTasks; t++) {
+        taskSuccessorOffsets[t + 1] += taskSuccessorOffsets[t];
+    }
+    taskSuccessors.resize(taskPredecessors.size());
+    std::vector<uint64_t> cursor(taskSuccessorOffsets.begin(), taskSuccessorOffsets.end() - 1);
+    for (size_t t = 0; t < numTasks; t++) {
+        for (int32_t d : getTaskPredecessors(t)) {
+            taskSuccessors[cursor[d]++] = static_cast<int32_t>(t);
+        }
+    }
+    
+    // Kahn's algorithm, one level at a time
+    std::vector<uint64_t> pending(numTasks);
+    topologicalOrder.clear();
+    topologicalOrder.reserve(numTasks);
+    for (size_t t = 0; t < numTasks; t++) {
+        pending[t] = taskPredecessorOffsets[t + 1] - taskPredecessorOffsets[t];
+        if (pending[t] == 0) {
+            topologicalOrder.push_back(static_cast<int32_t>(t));
+        }
+    }
+    levelOffsets.assign(1, 0);
+    size_t head = 0;
+    while (head < topologicalOrder.size()) {
+        size_t levelEnd = topologicalOrder.size();
+        for (; head < levelEnd; head++) {
+            for (int32_t s : getTaskSuccessors(topologicalOrder[head])) {
+                if (--pending[s] == 0) {
+                    topologicalOrder.push_back(s);
                 }
-                cycleStr += std::to_string(successorId);
-                throw std::runtime_error(cycleStr);
-            } else if (state[successorId] == 0) {
-                dfsVisit(successorId, state, path);
             }
         }
+        levelOffsets.push_back(levelEnd);
+    }
+    
+    if (topologicalOrder.size() == numTasks) {
+        return;
+    }
+    
+    // Every unsorted task still waits on an unsorted predecessor, so walking
+    // predecessors from any of them must revisit a task: that loop is a cycle
+    size_t start = 0;
+    while (pending[start] == 0) {
+        start++;
+    }
+    std::vector<int> stepOf(numTasks, -1);
+    std::vector<int32_t> walk;
+    int32_t cur = static_cast<int32_t>(start);
+    while (stepOf[cur] < 0) {
+        stepOf[cur] = static_cast<int>(walk.size());
+        walk.push_back(cur);
+        for (int32_t d : getTaskPredecessors(cur)) {
+            if (pending[d] > 0) {
+                cur = d;
+                break;
+            }
+        }
+    }
+    
+    // The walk followed edges backwards; print the loop in dependency order
+    std::string cycleStr = "Cycle detected in task dependencies: ";
+    for (size_t k = walk.size(); k-- > static_cast<size_t>(stepOf[cur]); ) {
+        cycleStr += std::to_string(tasks[walk[k]].id) + " -> ";
+    }
+    cycleStr += std::to_string(tasks[walk.back()].id);
+    cycleStr += " (" + std::to_string(numTasks - topologicalOrder.size()) +
+                " tasks on or behind a cycle)";
+    errors.push_back(cycleStr);
+}
+
+void TaskGraph::throwIfInvalid(const std::vector<std::string>& errors) {
+    const size_t kMaxListedErrors = 20;
+    if (errors.empty()) {
+        return;
     }
     
-    state[taskId] = 2;  // Mark as visited
-    path.pop_back();
+    std::string message = "Invalid task graph (" + std::to_string(errors.size()) +
+                          (errors.size() == 1 ? " error):" : " errors):");
+    for (size_t k = 0; k < errors.size() && k < kMaxListedErrors; k++) {
+        message += "\n  " + errors[k];
+    }
+    if (errors.size() > kMaxListedErrors) {
+        message += "\n  ... and " + std::to_string(errors.size() - kMaxListedErrors) + " more";
+    }
+    throw std::runtime_error(message);
 }
 
 std::vector<int> TaskGraph::getReadyInstances() const {
     std::vector<int> ready;
     
-    for (const auto& instance : instances) {
-        if (instance.inDegree == 0 && instance.currentOpIndex == 0 && instance.readyTime == 0) {
-            ready.push_back(instance.instanceId);
+    for (size_t id = 0; id < instances.size(); id++) {
+        int instanceId = static_cast<int>(id);
+        if (instances.inDegree(instanceId) == 0 && instances.opIndex(instanceId) == 0 &&
+            instances.readyTime(instanceId) == 0) {
+            ready.push_back(instanceId);
         }
     }
     
     return ready;
 }
 
-void TaskGraph::markInstanceComplete(int instanceId) {
-    const auto& instance = instances[instanceId];
+void TaskGraph::markInstanceComplete(int instanceId, uint64_t time, int coreId, std::vector<int>& newlyReady) {
+    if (materialization == InstanceMaterialization::Lazy) {
+        // Successor tasks become ready once all predecessor instances are done;
+        // like eager TaskReady events they remember the core that released them
+        int t = getTaskIndex(instances.taskId(instanceId));
+        for (int32_t s : getTaskSuccessors(t)) {
+            if (--pendingPredecessors[s] == 0 && tasks[s].executions > 0) {
+                readyTasks.push_back({tasks[s].id, 0, tasks[s].executions, time, coreId});
+            }
+        }
+        return;
+    }
     
     // Decrement in-degree of all successors
-    for (int successorId : instance.successors) {
-        instances[successorId].inDegree--;
+    for (int successorId : instances.successors(instanceId)) {
+        if (--instances.inDegree(successorId) == 0) {
+            instances.readyTime(successorId) = time;
+            newlyReady.push_back(successorId);
+        }
     }
 }
 
-const std::vector<Op>& TaskGraph::getOps(int taskId) const {
+int TaskGraph::materializeInstance(int& releasingCore) {
+    if (readyTasks.empty()) {
+        return -1;
+    }
+    
+    ReadyTask& ready = readyTasks.front();
+    releasingCore = ready.releasingCore;
+    
+    int slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = instances.add(ready.taskId, ready.nextExecution);
+    }
+    
+    instances.reset(slot, ready.taskId, ready.nextExecution, ready.readyTime);
+    
+    if (++ready.nextExecution == ready.executions) {
+        readyTasks.pop_front();
+    }
+    
+    liveInstances++;
+    peakLiveInstances = std::max(peakLiveInstances, liveInstances);
+    return slot;
+}
+
+void TaskGraph::releaseInstance(int instanceId) {
+    // Eager instances keep their records for the whole run
+    if (materialization != InstanceMaterialization::Lazy) {
+        return;
+    }
+    
+    instances.taskId(instanceId) = -1;
+    freeSlots.push_back(instanceId);
+    liveInstances--;
+}
+
+uint64_t TaskGraph::getTotalInstanceCount() const {
+    uint64_t total = 0;
     for (const auto& task : tasks) {
-        if (task.id == taskId) {
-            return task.ops;
+        total += task.executions;
+    }
+    return total;
+}
+
+OpSpan TaskGraph::getOps(int taskId) const {
+    int taskIndex = getTaskIndex(taskId);
+    if (taskIndex < 0) {
+        throw std::runtime_error("Task not found: " + std::to_string(taskId));
+    }
+    const Task& task = tasks[taskIndex];
+    return OpSpan(opData() + task.opBegin, task.opCount);
+}
+
+const TraceFile* TaskGraph::getTrace(int taskId) const {
+    int taskIndex = getTaskIndex(taskId);
+    if (taskIndex < 0 || tasks[taskIndex].trace < 0) {
+        return nullptr;
+    }
+    return traces[tasks[taskIndex].trace].get();
+}
+
+size_t TaskGraph::getProgramLength(int taskId) const {
+    const TraceFile* trace = getTrace(taskId);
+    return trace != nullptr ? trace->size() : getOps(taskId).size();
+}
+
+uint32_t TaskGraph::getOpTypes(int taskId) const {
+    if (getTrace(taskId) != nullptr) {
+        return opTypeBit(OpType::Compute) | opTypeBit(OpType::Memory);
+    }
+    uint32_t types = 0;
+    for (const Op& op : getOps(taskId)) {
+        if (op.type != OpType::Repeat && op.type != OpType::EndRepeat) {
+            types |= opTypeBit(op.type);
         }
     }
-    
-    throw std::runtime_error("Task not found: " + std::to_string(taskId));
+    return types;
 }
@@ -2,9 +2,20 @@
 #define TASKGRAPH_HPP
 
 #include "Types.hpp"
+#include "AddressExpr.hpp"
+#include "InstanceTable.hpp"
+#include "MappedFile.hpp"
+#include "TraceFile.hpp"
+#include <deque>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <memory>
 #include <string>
+#include <string_view>
+
+class CSVReader;
+enum class Compression;
 
 class TaskGraph {
 public:
@@ -13,29 +24,124 @@ public:
     // Load tasks and operations from CSV files
     void loadFromCSV(const std::string& tasksPath, const std::string& opsPath);
     
-    // Build DAG and create task instances
-    void buildDAG();
+    // Map a binary graph file written by saveBinary; ops are used in place
+    void loadFromBinary(const std::string& graphPath);
+    
+    // Write the loaded tasks and ops in the binary graph format (GraphFile.hpp)
+    void saveBinary(const std::string& graphPath) const;
+    
+    // Split an uncompressed ops.csv into this many parsing chunks; 0 (the
+    // default) takes one per MiB, up to the number of hardware threads
+    void setOpsChunkCount(size_t count) { opsChunkCount = count; }
+    
+    // Build DAG and create task instances (all up front, or on demand in lazy mode)
+    void buildDAG(InstanceMaterialization mode = InstanceMaterialization::Eager);
     
     // Query methods
     std::vector<int> getReadyInstances() const;
-    void markInstanceComplete(int instanceId);
-    const std::vector<Op>& getOps(int taskId) const;
+    void markInstanceComplete(int instanceId, uint64_t time, int coreId, std::vector<int>& newlyReady);
+    OpSpan getOps(int taskId) const;
+    
+    // Trace replayed by a task instead of ops, or nullptr
+    const TraceFile* getTrace(int taskId) const;
+    
+    // Steps in a task's program: ops, or records of its trace
+    size_t getProgramLength(int taskId) const;
+    
+    // opTypeBit of every op type a task issues; traces issue compute and memory
+    uint32_t getOpTypes(int taskId) const;
+    
+    // Resolve the address of a memory op for the given expression variables
+    uint64_t resolveAddress(const Op& op, const int64_t* vars) const {
+        return op.addrExpr < 0 ? op.address : addressExprs.evaluate(op.addrExpr, vars);
+    }
+    
+    // Lazy materialization: instances whose task is ready but have no record yet
+    bool hasPendingInstances() const { return !readyTasks.empty(); }
+    int materializeInstance(int& releasingCore);
+    void releaseInstance(int instanceId);
+    size_t getLiveInstanceCount() const { return liveInstances; }
+    size_t getPeakLiveInstanceCount() const { return peakLiveInstances; }
+    uint64_t getTotalInstanceCount() const;
     
     // Accessors
     const std::vector<Task>& getTasks() const { return tasks; }
-    const std::vector<TaskInstance>& getInstances() const { return instances; }
-    TaskInstance& getInstance(int instanceId) { return instances[instanceId]; }
-    const TaskInstance& getInstance(int instanceId) const { return instances[instanceId]; }
+    
+    // Dense task-level structure; task indices are positions in getTasks()
+    int getTaskIndex(int taskId) const {
+        auto it = taskIndexById.find(taskId);
+        return it != taskIndexById.end() ? it->second : -1;
+    }
+    IdSpan getTaskSuccessors(size_t taskIndex) const {
+        return IdSpan(taskSuccessors.data() + taskSuccessorOffsets[taskIndex],
+                      taskSuccessorOffsets[taskIndex + 1] - taskSuccessorOffsets[taskIndex]);
+    }
+    IdSpan getTaskPredecessors(size_t taskIndex) const {
+        return IdSpan(taskPredecessors.data() + taskPredecessorOffsets[taskIndex],
+                      taskPredecessorOffsets[taskIndex + 1] - taskPredecessorOffsets[taskIndex]);
+    }
+    // Task indices in topological order, grouped by level: level l spans
+    // [getLevelOffsets()[l], getLevelOffsets()[l + 1])
+    const std::vector<int32_t>& getTopologicalOrder() const { return topologicalOrder; }
+    const std::vector<size_t>& getLevelOffsets() const { return levelOffsets; }
+    size_t getOpCount() const { return mappedOps != nullptr ? mappedOpCount : opArena.size(); }
+    const Op* opData() const { return mappedOps != nullptr ? mappedOps : opArena.data(); }
+    const AddressExprPool& getAddressExprs() const { return addressExprs; }
+    InstanceTable& getInstances() { return instances; }
+    const InstanceTable& getInstances() const { return instances; }
     
 private:
     std::vector<Task> tasks;
-    std::vector<TaskInstance> instances;
-    std::map<int, std::vector<int>> adjacencyList;  // taskId -> list of successor taskIds
+    InstanceTable instances;                        // Runtime state, hot/cold split
+    std::vector<Op> opArena;                        // Ops of all tasks, contiguous per task
+    std::vector<std::shared_ptr<TraceFile>> traces; // Mapped traces, indexed by Task::trace
+    std::shared_ptr<MappedFile> graphFile;          // Backing file when loaded from binary
+    const Op* mappedOps = nullptr;                  // Op arena inside graphFile
+    size_t mappedOpCount = 0;
+    
+    // Task-level adjacency in CSR form over task indices, built by validateGraph
+    std::unordered_map<int, int> taskIndexById;
+    std::vector<uint64_t> taskSuccessorOffsets;
+    std::vector<int32_t> taskSuccessors;
+    std::vector<uint64_t> taskPredecessorOffsets;
+    std::vector<int32_t> taskPredecessors;
+    std::vector<int32_t> topologicalOrder;
+    std::vector<size_t> levelOffsets;
+    
+    AddressExprPool addressExprs;                   // Compiled per-instance address expressions
+    size_t opsChunkCount = 0;                       // Parsing chunks of ops.csv, 0 for automatic
+    
+    // Lazy materialization state
+    struct ReadyTask {
+        int taskId;
+        int nextExecution;
+        int executions;
+        uint64_t readyTime;
+        int releasingCore;                          // Core whose completion readied the task, or -1
+    };
+    InstanceMaterialization materialization = InstanceMaterialization::Eager;
+    std::vector<int64_t> pendingPredecessors;       // Per task index: predecessor instances not yet done
+    std::deque<ReadyTask> readyTasks;               // Ready tasks with instances left to create
+    std::vector<int> freeSlots;                     // Recycled entries of instances
+    size_t liveInstances = 0;
+    size_t peakLiveInstances = 0;
+    
+    // ops.csv parsing state, defined in TaskGraph.cpp
+    struct OpsColumns;
+    struct OpsChunk;
     
     // Helper methods
-    std::vector<int> parseDependencies(const std::string& depsStr);
-    void detectCycles();
-    void dfsVisit(int taskId, std::map<int, int>& state, std::vector<int>& path);
+    static bool parseDependencies(std::string_view depsStr, std::vector<int>& deps);
+    static Op parseAddressField(Op op, std::string_view addrStr, AddressExprPool& exprs);
+    static OpsColumns findOpsColumns(const CSVReader& header);
+    void parseMappedOps(const MappedFile& opsFile, std::vector<OpsChunk>& chunks) const;
+    void parseCompressedOps(const MappedFile& opsFile, Compression format, std::vector<OpsChunk>& chunks) const;
+    void parseOpsChunk(CSVReader& reader, const OpsColumns& columns, OpsChunk& chunk) const;
+    static void linkRepeatBlocks(const Task& task, Op* ops, size_t count, const AddressExprPool& exprs);
+    static void checkMappedOps(const Task& task, const Op* ops, const AddressExprPool& exprs,
+                               const std::vector<bool>& exprStarts);
+    void validateGraph(std::vector<std::string>& errors);
+    static void throwIfInvalid(const std::vector<std::string>& errors);
 };
 
 #endif // TASKGRAPH_HPP
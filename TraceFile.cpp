@@ -0,0 +1,61 @@
+#include "TraceFile.hpp"
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+TraceFile::TraceFile(const std::string& path) : file(path), first(nullptr), count(0) {
+    auto fail = [&](const std::string& reason) {
+        throw std::runtime_error("Invalid trace file " + path + ": " + reason);
+    };
+    
+    if (file.size() < sizeof(TraceFileHeader)) {
+        fail("file too small");
+    }
+    
+    TraceFileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    
+    if (std::memcmp(header.magic, kTraceFileMagic, sizeof(header.magic)) != 0) {
+        fail("bad magic");
+    }
+    if (header.version != kTraceFileVersion) {
+        fail("unsupported version " + std::to_string(header.version));
+    }
+    if (header.byteOrderMark != kTraceFileByteOrderMark || header.recordSize != sizeof(TraceRecord)) {
+        fail("written with an incompatible record layout");
+    }
+    uint64_t bodyBytes = file.size() - sizeof(TraceFileHeader);
+    if (bodyBytes % sizeof(TraceRecord) != 0 || header.recordCount != bodyBytes / sizeof(TraceRecord)) {
+        fail("size does not match its record count");
+    }
+    
+    // Replay position is kept in the instance's 32-bit op index
+    if (header.recordCount > static_cast<uint64_t>(INT32_MAX)) {
+        fail("more than " + std::to_string(INT32_MAX) + " records");
+    }
+    
+    first = reinterpret_cast<const TraceRecord*>(file.data() + sizeof(TraceFileHeader));
+    count = header.recordCount;
+    file.adviseSequential();
+}
+
+void TraceFile::write(const std::string& path, const TraceRecord* records, size_t count) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open trace file for writing: " + path);
+    }
+    
+    TraceFileHeader header = {};
+    std::memcpy(header.magic, kTraceFileMagic, sizeof(header.magic));
+    header.version = kTraceFileVersion;
+    header.byteOrderMark = kTraceFileByteOrderMark;
+    header.recordSize = sizeof(TraceRecord);
+    header.recordCount = count;
+    
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records), static_cast<std::streamsize>(count * sizeof(TraceRecord)));
+    if (!out) {
+        throw std::runtime_error("Failed to write trace file: " + path);
+    }
+}
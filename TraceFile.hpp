@@ -0,0 +1,76 @@
+#ifndef TRACEFILE_HPP
+#define TRACEFILE_HPP
+
+#include "MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Binary memory-access trace replayed as the program of a task.
+//
+// Layout: TraceFileHeader, then TraceRecord[recordCount]. Each record is one
+// access preceded by `gap` compute cycles; accesses are split at 64-byte
+// line boundaries, the transfer size of MemorySystem. Records use the host's
+// native layout; the header carries a byte-order mark and the record size.
+
+constexpr char kTraceFileMagic[8] = {'M', 'C', 'S', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t kTraceFileVersion = 1;
+constexpr uint32_t kTraceFileByteOrderMark = 0x01020304;
+constexpr uint64_t kTraceLineBytes = 64;
+
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t recordSize;        // sizeof(TraceRecord) of the writer
+    uint32_t reserved;
+    uint64_t recordCount;
+};
+
+struct TraceRecord {
+    uint64_t address;
+    uint32_t gap;               // Compute cycles before the access
+    uint16_t size;              // Bytes accessed (0 is treated as 1)
+    uint8_t rw;                 // 0 = read, 1 = write (AccessType)
+    uint8_t reserved;
+};
+
+/**
+ * TraceFile class
+ * Read-only mapping of a trace file. Records are used in place, so a trace
+ * costs address space but no heap, and the kernel pages it in and out as
+ * replay walks through it.
+ */
+class TraceFile {
+public:
+    /**
+     * Map and check a trace file
+     * @param path Trace file written by write() or an external tool
+     */
+    explicit TraceFile(const std::string& path);
+
+    /**
+     * Write records in the trace format
+     * @param path Output file
+     * @param records Records to store
+     * @param count Number of records
+     */
+    static void write(const std::string& path, const TraceRecord* records, size_t count);
+
+    const TraceRecord* records() const { return first; }
+    size_t size() const { return count; }
+    const std::string& path() const { return file.path(); }
+
+    // 64-byte lines touched by one record
+    static uint64_t lineCount(const TraceRecord& record) {
+        uint64_t last = record.address + (record.size > 0 ? record.size : 1) - 1;
+        return last / kTraceLineBytes - record.address / kTraceLineBytes + 1;
+    }
+
+private:
+    MappedFile file;
+    const TraceRecord* first;
+    size_t count;
+};
+
+#endif // TRACEFILE_HPP
@@ -1,6 +1,7 @@
 #ifndef TYPES_HPP
 #define TYPES_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -21,9 +22,20 @@ enum class EventType {
 // Operation types
 enum class OpType {
     Compute,
-    Memory
+    Memory,
+    Repeat,      // Opens a repeat block; cycles holds the trip count
+    EndRepeat,   // Closes a repeat block; cycles holds the index of its Repeat op
+    Fence        // Waits until every outstanding memory request of the core has completed
 };
 
+// Bit of an op type in a core class's capability mask
+constexpr uint32_t opTypeBit(OpType type) { return 1u << static_cast<unsigned>(type); }
+constexpr uint32_t kAllOpTypes = opTypeBit(OpType::Compute) | opTypeBit(OpType::Memory) |
+                                 opTypeBit(OpType::Fence);
+
+// Maximum nesting depth of repeat blocks within one task
+constexpr int kMaxLoopDepth = 4;
+
 // Memory access types
 enum class AccessType {
     Read,
@@ -34,7 +46,26 @@ enum class AccessType {
 enum class SchedulingPolicy {
     FIFO,
     RoundRobin,
-    ShortestOpsFirst
+    ShortestOpsFirst,
+    CriticalPath,       // Highest upward rank (longest chain to a sink) first
+    Affinity,           // FIFO, on a core of the chiplet holding most of the instance's data
+    WorkStealing,       // Per-core deques; idle cores steal from a victim
+    Hierarchical,       // Per-chiplet schedulers with modeled dispatch cost, plus a balancer
+    BandwidthAware,     // FIFO that holds back memory-bound instances while the banks are busy
+    EarliestDeadline,   // Earliest absolute deadline first; instances without one last
+    EarliestFinishTime  // Oldest first, on the core class with the earliest estimated finish
+};
+
+// Victim choice of the work-stealing policy
+enum class StealVictim {
+    Random,             // Uniformly random core with queued work
+    Chiplet             // Same as Random, trying the thief's own chiplet first
+};
+
+// When task instance records are created
+enum class InstanceMaterialization {
+    Eager,      // All instances and instance-level edges built up front
+    Lazy        // Instances created as they become ready and recycled after completion
 };
 
 // Bank index functions
@@ -62,11 +93,42 @@ struct Op {
     int cycles;           // Compute cycles (0 for memory ops)
     uint64_t address;     // Memory address (0 for compute)
     AccessType rw;        // Read or Write
+    int addrExpr;         // Address expression id, -1 when address is a literal
     
-    Op() : type(OpType::Compute), cycles(0), address(0), rw(AccessType::Read) {}
+    Op() : type(OpType::Compute), cycles(0), address(0), rw(AccessType::Read), addrExpr(-1) {}
     
     Op(OpType t, int c, uint64_t addr, AccessType access)
-        : type(t), cycles(c), address(addr), rw(access) {}
+        : type(t), cycles(c), address(addr), rw(access), addrExpr(-1) {}
+};
+
+// Read-only view of a task's operations inside the task graph's op arena
+struct OpSpan {
+    const Op* first;
+    size_t count;
+    
+    OpSpan() : first(nullptr), count(0) {}
+    OpSpan(const Op* ops, size_t n) : first(ops), count(n) {}
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Op& operator[](size_t idx) const { return first[idx]; }
+    const Op* begin() const { return first; }
+    const Op* end() const { return first + count; }
+};
+
+// Read-only view of a run of ids inside a CSR target array
+struct IdSpan {
+    const int32_t* first;
+    size_t count;
+    
+    IdSpan() : first(nullptr), count(0) {}
+    IdSpan(const int32_t* ids, size_t n) : first(ids), count(n) {}
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    int32_t operator[](size_t idx) const { return first[idx]; }
+    const int32_t* begin() const { return first; }
+    const int32_t* end() const { return first + count; }
 };
 
 // Event structure for discrete-event simulation
@@ -93,32 +155,49 @@ struct Task {
     std::string name;
     int executions;
     std::vector<int> dependencies;  // IDs of predecessor tasks
-    std::vector<Op> ops;            // Sequence of operations
+    uint64_t opBegin;               // First op in the graph's op arena
+    uint64_t opCount;               // Number of ops (including repeat/end)
+    int trace;                      // Index of the graph's trace file replayed instead of ops, or -1
+    uint64_t deadline;              // Cycles from an instance's ready time to its deadline, 0 for none
+    std::string coreClass;          // Name of the core class the task prefers, empty for none
     
-    Task() : id(-1), name(""), executions(1) {}
+    Task() : id(-1), name(""), executions(1), opBegin(0), opCount(0), trace(-1), deadline(0) {}
     
     Task(int taskId, const std::string& taskName, int exec)
-        : id(taskId), name(taskName), executions(exec) {}
+        : id(taskId), name(taskName), executions(exec), opBegin(0), opCount(0), trace(-1), deadline(0) {}
 };
 
-// TaskInstance structure representing a runtime instance of a task
-struct TaskInstance {
-    int instanceId;
+// Static timing bounds of one task from the graph analysis pass
+struct TaskBound {
     int taskId;
-    int currentOpIndex;
-    int inDegree;                   // Number of unsatisfied dependencies
-    uint64_t readyTime;             // Cycle when became ready
-    uint64_t dispatchTime;          // Cycle when dispatched
-    uint64_t doneTime;              // Cycle when completed
-    std::vector<int> successors;    // Instance IDs of dependent instances
+    uint64_t cost;            // Lower bound on one instance's duration
+    uint64_t memoryOps;       // Memory accesses of one instance (trace lines for traces)
+    uint64_t earliestStart;   // Longest path from the sources to the task
+    uint64_t upwardRank;      // Longest path from the task (inclusive) to a sink
+    uint64_t instanceRank;    // Same with one instance per task (HEFT upward rank)
+    uint64_t slack;           // Critical path minus the longest path through the task
     
-    TaskInstance() 
-        : instanceId(-1), taskId(-1), currentOpIndex(0), inDegree(0),
-          readyTime(0), dispatchTime(0), doneTime(0) {}
+    TaskBound() : taskId(-1), cost(0), memoryOps(0), earliestStart(0), upwardRank(0), instanceRank(0), slack(0) {}
+};
+
+// Work done by one scheduler of the hierarchical policy
+struct SchedulerLoad {
+    uint64_t dispatches;      // Instances dispatched (or migrated, for the balancer)
+    uint64_t busyCycles;      // Cycles spent dispatching
+    uint64_t queueingDelay;   // Cycles instances waited for the scheduler, summed
+    
+    SchedulerLoad() : dispatches(0), busyCycles(0), queueingDelay(0) {}
+};
+
+// Makespan lower bounds computed before simulation
+struct GraphBounds {
+    uint64_t criticalPath;    // Longest dependency chain, ignoring core count
+    uint64_t totalWork;       // Sum of instance costs over all instances
+    uint64_t workBound;       // totalWork spread evenly over all cores
+    uint64_t lowerBound;      // max(criticalPath, workBound)
+    std::vector<TaskBound> tasks;
     
-    TaskInstance(int instId, int tId, int degree)
-        : instanceId(instId), taskId(tId), currentOpIndex(0), inDegree(degree),
-          readyTime(0), dispatchTime(0), doneTime(0) {}
+    GraphBounds() : criticalPath(0), totalWork(0), workBound(0), lowerBound(0) {}
 };
 
 #endif // TYPES_HPP
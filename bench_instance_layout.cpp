@@ -0,0 +1,131 @@
+// Microbenchmark: task instance state as an array of structs versus the
+// hot/cold split InstanceTable used by TaskGraph.
+//
+// Two loops dominate instance access in a simulation run:
+//   - op stepping: read taskId and advance opIndex of a running instance
+//   - dependency release: decrement inDegree of every successor instance
+// Both are timed over a large fan-out graph in both layouts.
+//
+// Usage: bench_instance_layout [instances] [rounds]
+
+#include "InstanceTable.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Previous array-of-structs layout of a task instance
+struct TaskInstance {
+    int instanceId;
+    int taskId;
+    int executionIndex;
+    int currentOpIndex;
+    int inDegree;
+    uint64_t readyTime;
+    uint64_t dispatchTime;
+    uint64_t doneTime;
+    std::vector<int> successors;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t numInstances = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+    const int kFanOut = 4;
+
+    // Random visiting order models instances completing out of id order
+    std::mt19937 rng(42);
+    std::vector<int> order(numInstances);
+    for (size_t i = 0; i < numInstances; i++) {
+        order[i] = static_cast<int>(i);
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::vector<TaskInstance> aos(numInstances);
+    InstanceTable soa;
+    std::vector<uint64_t> offsets(1, 0);
+    std::vector<int32_t> targets;
+    std::uniform_int_distribution<int> pick(0, static_cast<int>(numInstances) - 1);
+    for (size_t i = 0; i < numInstances; i++) {
+        int id = soa.add(static_cast<int32_t>(i % 64), 0, 0);
+        aos[i].instanceId = id;
+        aos[i].taskId = static_cast<int>(i % 64);
+        aos[i].currentOpIndex = 0;
+        aos[i].inDegree = 0;
+        for (int s = 0; s < kFanOut; s++) {
+            int succ = pick(rng);
+            aos[i].successors.push_back(succ);
+            targets.push_back(succ);
+        }
+        offsets.push_back(targets.size());
+    }
+    soa.assignSuccessors(std::move(offsets), std::move(targets));
+
+    std::cout << "Instances: " << numInstances << ", rounds: " << rounds
+              << ", sizeof(TaskInstance): " << sizeof(TaskInstance) << " bytes" << std::endl;
+
+    // Op stepping: one op advance per instance per round
+    uint64_t checksum = 0;
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int id : order) {
+            checksum += aos[id].taskId;
+            aos[id].currentOpIndex++;
+        }
+    }
+    double aosStep = millisSince(start);
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int id : order) {
+            checksum += soa.taskId(id);
+            soa.opIndex(id)++;
+        }
+    }
+    double soaStep = millisSince(start);
+
+    // Dependency release: decrement successors of every completed instance
+    start = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int id : order) {
+            for (int succ : aos[id].successors) {
+                if (--aos[succ].inDegree == 0) {
+                    checksum++;
+                }
+            }
+        }
+    }
+    double aosRelease = millisSince(start);
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int id : order) {
+            for (int succ : soa.successors(id)) {
+                if (--soa.inDegree(succ) == 0) {
+                    checksum++;
+                }
+            }
+        }
+    }
+    double soaRelease = millisSince(start);
+
+    std::cout << "Op stepping:        AoS " << aosStep << " ms, SoA " << soaStep << " ms" << std::endl;
+    std::cout << "Dependency release: AoS " << aosRelease << " ms, SoA " << soaRelease << " ms" << std::endl;
+    std::cout << "Edge storage:       AoS ~" << soa.nestedEdgeBytes() / (1024 * 1024)
+              << " MiB, SoA " << soa.edgeBytes() / (1024 * 1024) << " MiB" << std::endl;
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+    return 0;
+}
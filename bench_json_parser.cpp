@@ -0,0 +1,92 @@
+// Microbenchmark: JSONParser on a large parameter-sweep file.
+//
+// The file is an array of configuration points, each with per-core and
+// per-bank arrays, generated in memory to the requested size. Each round
+// parses the text and walks every node, so the time covers building and
+// reading the DOM but not I/O.
+//
+// Usage: bench_json_parser [megabytes] [rounds]
+
+#include "JSONParser.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string makeSweep(size_t bytes) {
+    std::string text = "{\n  \"name\": \"bank_sweep\",\n  \"points\": [\n";
+    char buffer[160];
+    for (int point = 0; text.size() < bytes; point++) {
+        if (point > 0) {
+            text += ",\n";
+        }
+        std::snprintf(buffer, sizeof(buffer),
+                      "    {\"label\": \"point_%d\", \"cores\": %d, \"frequency_ghz\": %.2f,\n"
+                      "     \"cache\": {\"enabled\": %s, \"size_bytes\": %d},\n     \"per_core\": [",
+                      point, 16 << (point % 4), 1.0 + (point % 7) * 0.25,
+                      point % 2 ? "true" : "false", 16384 << (point % 3));
+        text += buffer;
+        for (int core = 0; core < 64; core++) {
+            std::snprintf(buffer, sizeof(buffer), "%s{\"dtcm_base\": \"0x%x\", \"latency\": %d}",
+                          core ? ", " : "", 0x10000000 + core * 0x4000, 1 + (core + point) % 4);
+            text += buffer;
+        }
+        text += "],\n     \"bank_latency_cycles\": [";
+        for (int bank = 0; bank < 64; bank++) {
+            std::snprintf(buffer, sizeof(buffer), "%s%d", bank ? ", " : "", 20 + (bank * 7 + point) % 40);
+            text += buffer;
+        }
+        text += "]}";
+    }
+    text += "\n  ]\n}\n";
+    return text;
+}
+
+// Touch every node so lazy work cannot hide in the walk
+double walk(const JSONValue& value) {
+    double sum = static_cast<double>(value.key().size());
+    switch (value.type) {
+        case JSONType::Number: return sum + value.asNumber();
+        case JSONType::String: return sum + static_cast<double>(value.asString().size());
+        case JSONType::Boolean: return sum + (value.asBool() ? 1 : 0);
+        case JSONType::Object:
+            for (const JSONValue& member : value.asObject()) sum += walk(member);
+            return sum;
+        case JSONType::Array:
+            for (const JSONValue& element : value.asArray()) sum += walk(element);
+            return sum;
+        default: return sum;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::string text = makeSweep(megabytes << 20);
+    double checksum = 0;
+    double best = 1e30;
+    size_t nodes = 0;
+    for (int r = 0; r < rounds; r++) {
+        auto start = Clock::now();
+        JSONDocument doc = JSONParser::parseString(text);
+        checksum += walk(doc.value());
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        best = std::min(best, ms);
+        nodes = doc.nodeCount();
+    }
+
+    std::cout << "Sweep: " << text.size() / (1024.0 * 1024.0) << " MiB, " << nodes << " nodes" << std::endl;
+    std::cout << "Parse and walk: " << best << " ms (" << text.size() / (best * 1000.0) << " MB/s), best of "
+              << rounds << std::endl;
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <iostream>
+#include <string>
+#include <map>
+#include <stdexcept>
+#include "src/TaskGraph.hpp"
+
+/**
+ * csv2graph: convert tasks.csv/ops.csv into the binary graph format that the
+ * simulator maps with --graph, skipping CSV parsing on every run.
+ */
+
+std::map<std::string, std::string> parseArgs(int argc, char* argv[]) {
+    std::map<std::string, std::string> args;
+    
+    // Parse arguments in the form --key value
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.substr(0, 2) == "--" && i + 1 < argc) {
+            args[arg.substr(2)] = argv[i + 1];
+            ++i;
+        }
+    }
+    
+    return args;
+}
+
+int main(int argc, char* argv[]) {
+    std::map<std::string, std::string> args = parseArgs(argc, argv);
+    
+    if (args.find("tasks") == args.end() || 
+        args.find("ops") == args.end() || 
+        args.find("out") == args.end()) {
+        std::cerr << "Usage: " << argv[0] << " --tasks <tasks.csv> --ops <ops.csv> --out <graph.mcg>" << std::endl;
+        return 1;
+    }
+    
+    try {
+        TaskGraph graph;
+        graph.loadFromCSV(args["tasks"], args["ops"]);
+        graph.saveBinary(args["out"]);
+        
+        std::cout << "Wrote " << args["out"] << ": " << graph.getTasks().size() << " tasks, "
+                  << graph.getOpCount() << " ops" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
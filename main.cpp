@@ -34,11 +34,18 @@ std::map<std::string, std::string> parseArgs(int argc, char* argv[]) {
  */
 void displayUsage(const char* programName) {
     std::cerr << "Usage: " << programName << " --config <config.json> --tasks <tasks.csv> --ops <ops.csv>" << std::endl;
+    std::cerr << "       " << programName << " --config <config.json> --graph <graph.mcg>" << std::endl;
     std::cerr << std::endl;
     std::cerr << "Required arguments:" << std::endl;
     std::cerr << "  --config <file>  Path to configuration JSON file" << std::endl;
     std::cerr << "  --tasks <file>   Path to tasks CSV file" << std::endl;
     std::cerr << "  --ops <file>     Path to operations CSV file" << std::endl;
+    std::cerr << "  --graph <file>   Binary graph from csv2graph (replaces --tasks/--ops)" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Optional arguments:" << std::endl;
+    std::cerr << "  --target-cycles <n>  Skip simulation (exit code 2) if the makespan" << std::endl;
+    std::cerr << "                       lower bound already exceeds n cycles" << std::endl;
+    std::cerr << "  --stats <file>       Statistics JSON output (default stats.json)" << std::endl;
     std::cerr << std::endl;
     std::cerr << "Example:" << std::endl;
     std::cerr << "  " << programName << " --config example_config.json --tasks test_tasks.csv --ops test_ops.csv" << std::endl;
@@ -53,9 +60,9 @@ int main(int argc, char* argv[]) {
         std::map<std::string, std::string> args = parseArgs(argc, argv);
         
         // Validate all required arguments are provided
-        if (args.find("config") == args.end() || 
-            args.find("tasks") == args.end() || 
-            args.find("ops") == args.end()) {
+        bool haveGraph = args.find("graph") != args.end();
+        bool haveCSV = args.find("tasks") != args.end() && args.find("ops") != args.end();
+        if (args.find("config") == args.end() || (!haveGraph && !haveCSV)) {
             std::cerr << "Error: Missing required arguments" << std::endl << std::endl;
             displayUsage(argv[0]);
             return 1;
@@ -63,20 +70,28 @@ int main(int argc, char* argv[]) {
         
         // Extract file paths
         std::string configPath = args["config"];
-        std::string tasksPath = args["tasks"];
-        std::string opsPath = args["ops"];
         
         // Create Simulator instance
         Simulator simulator;
+        if (args.find("target-cycles") != args.end()) {
+            simulator.setTargetCycles(std::stoull(args["target-cycles"]));
+        }
+        if (args.find("stats") != args.end()) {
+            simulator.setStatsPath(args["stats"]);
+        }
         
         // Initialize simulator with file paths
-        simulator.initialize(configPath, tasksPath, opsPath);
+        if (haveGraph) {
+            simulator.initializeFromGraph(configPath, args["graph"]);
+        } else {
+            simulator.initialize(configPath, args["tasks"], args["ops"]);
+        }
         
         // Run simulation
         simulator.run();
         
-        // Success
-        return 0;
+        // Distinguish runs pruned by --target-cycles from completed ones
+        return simulator.wasSkipped() ? 2 : 0;
         
     } catch (const std::exception& e) {
         // Handle exceptions and display error messages
@@ -0,0 +1,82 @@
+#include "AddressExpr.hpp"
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+
+int main() {
+    std::cout << "Testing AddressExprPool..." << std::endl;
+    
+    AddressExprPool pool;
+    int64_t vars[AddressExprPool::kNumVariables] = {3, 5, 0, 0, 0};  // i=3, j=5
+    
+    // Test 1: Affine expression over i and j
+    int tiled = pool.compile("0x10000000 + i*0x1000 + j*64");
+    assert(pool.evaluate(tiled, vars) == 0x10000000 + 3 * 0x1000 + 5 * 64);
+    assert(pool.highestVariable(tiled) == 1);
+    std::cout << "Test 1 passed: Affine expression" << std::endl;
+    
+    // Test 2: Precedence, parentheses, division and modulo
+    int grid = pool.compile("(i / 2) * 100 + i % 2 - -1");
+    assert(pool.evaluate(grid, vars) == 1 * 100 + 1 + 1);
+    std::cout << "Test 2 passed: Operator precedence" << std::endl;
+    
+    // Test 3: Constant expressions reference no variables
+    int constant = pool.compile("0x100 + 16");
+    assert(pool.highestVariable(constant) == -1);
+    assert(pool.evaluate(constant, nullptr) == 0x110);
+    std::cout << "Test 3 passed: Constant expression" << std::endl;
+    
+    // Test 4: Malformed expressions are rejected
+    const char* invalid[] = {"i +", "(i * 2", "x + 1", "i j", "index"};
+    for (const char* text : invalid) {
+        try {
+            pool.compile(text);
+            std::cerr << "ERROR: Expression should have been rejected: " << text << std::endl;
+            return 1;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    assert(pool.evaluate(tiled, vars) == 0x10000000 + 3 * 0x1000 + 5 * 64);
+    std::cout << "Test 4 passed: Invalid expressions rejected" << std::endl;
+    
+    // Test 5: Deep nesting is a load error rather than a stack overflow
+    for (const char* open : {"(", "-"}) {
+        std::string deep(300000, open[0]);
+        deep += "1";
+        if (open[0] == '(') {
+            deep += std::string(300000, ')');
+        }
+        try {
+            pool.compile(deep);
+            std::cerr << "ERROR: Deeply nested expression should have been rejected" << std::endl;
+            return 1;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    assert(pool.evaluate(pool.compile("((((-(-(i))))))"), vars) == 3);
+    std::cout << "Test 5 passed: Nesting limit" << std::endl;
+    
+    // Test 6: INT64_MIN / -1 is reported instead of trapping
+    int overflow = pool.compile("(0-9223372036854775807-1-i)/(i-1)");
+    int64_t minusOne[AddressExprPool::kNumVariables] = {0, 0, 0, 0, 0};
+    try {
+        pool.evaluate(overflow, minusOne);
+        std::cerr << "ERROR: Overflowing division should have thrown" << std::endl;
+        return 1;
+    } catch (const std::runtime_error&) {
+    }
+    assert(pool.evaluate(pool.compile("(0-9223372036854775807-1-i)%(i-1)"), minusOne) == 0);
+    std::cout << "Test 6 passed: Division overflow" << std::endl;
+    
+    // Test 7: Add, Sub, Mul and Neg wrap around modulo 2^64 near INT64_MAX
+    int64_t one[AddressExprPool::kNumVariables] = {1, 0, 0, 0, 0};
+    assert(pool.evaluate(pool.compile("0x7fffffffffffffff + i"), one) == 0x8000000000000000ull);
+    assert(pool.evaluate(pool.compile("0 - 0x7fffffffffffffff - i - i"), one) == 0x7fffffffffffffffull);
+    assert(pool.evaluate(pool.compile("0x4000000000000000 * (i + 3)"), one) == 0);
+    assert(pool.evaluate(pool.compile("-(0 - 0x7fffffffffffffff - i)"), one) == 0x8000000000000000ull);
+    assert(pool.evaluate(pool.compile("0xffffffffffffffff + i"), one) == 0);
+    std::cout << "Test 7 passed: Wrap-around arithmetic" << std::endl;
+    
+    std::cout << "\nAll AddressExprPool tests passed!" << std::endl;
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include "Config.hpp"
 #include <iostream>
 #include <cassert>
+#include <fstream>
+#include <vector>
 
 int main() {
     try {
@@ -42,6 +44,15 @@ int main() {
         assert(config.remoteChipletPenalty == 20);
         assert(config.frequencyGHz == 2.0);
         
+        // Work stealing is not configured: free steals from random victims
+        assert(config.stealVictim == StealVictim::Random);
+        assert(config.stealLatency == 0);
+        assert(config.dispatchLatency == 0 && config.dispatchInterval == 0 && config.migrationCost == 0);
+        assert(config.memoryIntensity == 0.01 && config.occupancyThreshold == 1.0);
+        assert(config.lsqDepth == 1);  // Blocking cores
+        assert(config.threadContexts == 1 && config.contextSwitchCycles == 0);
+        assert(config.getContextCount() == 4 && config.contextToChiplet == config.coreToChiplet);
+        
         // Test chiplet mapping methods
         assert(config.getCoreChiplet(0) == 0);
         assert(config.getCoreChiplet(1) == 1);
@@ -53,6 +64,33 @@ int main() {
         assert(config.getBankChiplet(2) == 0);
         assert(config.getBankChiplet(3) == 1);
         
+        assert(config.coreClasses.empty() && config.getCoreClass(0) == nullptr);
+        
+        // Test core classes: consecutive cores per class, DTCM and op types default to all
+        {
+            std::ofstream classes("test_classes_config.json");
+            classes << "{\"cores\": 3, \"dtcm\": {\"enabled\": true, \"base_address\": \"0x80000000\",\n"
+                    << " \"size_bytes\": 16384, \"latency_cycles\": 1},\n"
+                    << " \"core_classes\": [{\"name\": \"big\", \"count\": 1, \"compute_speed\": 2.0},\n"
+                    << "  {\"name\": \"little\", \"count\": 2, \"dtcm_size_bytes\": 4096,\n"
+                    << "   \"op_types\": [\"compute\", \"mem\"]}]}\n";
+        }
+        Config hetero = Config::loadFromFile("test_classes_config.json");
+        assert(hetero.coreToClass == std::vector<int>({0, 1, 1}));
+        assert(hetero.getCoreClass(0)->computeSpeed == 2.0 && hetero.getCoreClass(0)->dtcmSize == 16384);
+        assert(hetero.getCoreClass(0)->opTypes == kAllOpTypes);
+        assert(hetero.getCoreClass(2)->computeSpeed == 1.0 && hetero.getCoreClass(2)->dtcmSize == 4096);
+        assert(!(hetero.getCoreClass(2)->opTypes & opTypeBit(OpType::Fence)));
+        assert(hetero.findCoreClass("little") == 1 && hetero.findCoreClass("dsp") == -1);
+        hetero.coreClasses[1].count = 1;
+        try {
+            hetero.validate();
+            std::cerr << "ERROR: Validation should have failed for core class counts" << std::endl;
+            return 1;
+        } catch (const std::runtime_error& e) {
+            std::cout << "Validation correctly caught error: " << e.what() << std::endl;
+        }
+        
         std::cout << "All Config tests passed!" << std::endl;
         
         // Test validation with invalid config
@@ -0,0 +1,119 @@
+#include "Core.hpp"
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <vector>
+
+// Start instance k on cores[k] and answer every request after a fixed
+// latency; returns the last completion time and the peak requests in flight
+static uint64_t runInstances(TaskGraph& graph, std::vector<Core>& cores,
+                             const std::vector<int>& instanceIds, int& peakInFlight) {
+    const uint64_t kMemoryLatency = 100;
+    EventQueue events;
+    for (size_t k = 0; k < instanceIds.size(); k++) {
+        cores[k].startInstance(instanceIds[k], 0, events, graph);
+    }
+    peakInFlight = 0;
+    size_t running = instanceIds.size();
+
+    while (!events.empty()) {
+        Event e = events.pop();
+        Core& core = cores[e.coreId];
+        peakInFlight = std::max(peakInFlight, core.getOutstandingRequests());
+        switch (e.type) {
+            case EventType::MemReqIssued:
+                events.push(Event(EventType::MemRespDone, e.time + kMemoryLatency, e.coreId,
+                                  e.taskInstanceId, e.address, e.context));
+                break;
+            case EventType::MemRespDone:
+                core.completeMemoryOp(static_cast<AccessType>(e.context), e.time, events, graph);
+                break;
+            case EventType::ComputeDone:
+                core.completeOp(e.time, events, graph);
+                break;
+            case EventType::TaskDone:
+                assert(core.isIdle() && core.getOutstandingRequests() == 0);
+                if (--running == 0) {
+                    return e.time;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    assert(false && "instance did not complete");
+    return 0;
+}
+
+static uint64_t runInstance(TaskGraph& graph, int instanceId, int lsqDepth, int& peakInFlight) {
+    std::vector<Core> cores{Core(0, lsqDepth)};
+    return runInstances(graph, cores, {instanceId}, peakInFlight);
+}
+
+int main() {
+    {
+        std::ofstream tasks("test_core_tasks.csv");
+        tasks << "id,name,executions,deps\n"
+              << "1,Gather,1,\n"
+              << "2,Publish,1,\n"
+              << "3,Crunch,2,\n";
+        std::ofstream ops("test_core_ops.csv");
+        ops << "task_id,seq_idx,type,cycles,address,rw\n"
+            << "1,0,repeat,4,,\n"
+            << "1,1,mem,0,0x1000 + j*64,R\n"
+            << "1,2,end,,,\n"
+            << "1,3,compute,10,,\n"
+            << "2,0,mem,0,0x2000,W\n"
+            << "2,1,mem,0,0x2040,W\n"
+            << "2,2,compute,10,,\n"
+            << "2,3,fence,,,\n"
+            << "2,4,mem,0,0x3000,W\n"
+            << "3,0,compute,50,,\n"
+            << "3,1,mem,0,0x4000,R\n"
+            << "3,2,compute,50,,\n";
+    }
+    TaskGraph graph;
+    graph.loadFromCSV("test_core_tasks.csv", "test_core_ops.csv");
+    graph.buildDAG();
+    int gather = 0;
+    int publish = 1;
+    assert(graph.getInstances().taskId(gather) == 1 && graph.getInstances().taskId(publish) == 2);
+    assert(graph.getInstances().taskId(2) == 3 && graph.getInstances().taskId(3) == 3);
+    int peak = 0;
+
+    // Test 1: A blocking core runs the four loads one after another
+    assert(runInstance(graph, gather, 1, peak) == 4 * 100 + 10 && peak == 1);
+    std::cout << "Test 1 passed: Blocking core\n";
+
+    // Test 2: Independent loads overlap up to the queue depth; compute waits for them
+    graph.getInstances().opIndex(gather) = 0;
+    assert(runInstance(graph, gather, 4, peak) == 100 + 10 && peak == 4);
+    graph.getInstances().opIndex(gather) = 0;
+    assert(runInstance(graph, gather, 2, peak) == 2 * 100 + 10 && peak == 2);
+    std::cout << "Test 2 passed: Loads overlap up to the queue depth\n";
+
+    // Test 3: Compute runs beside outstanding stores; the fence waits for them
+    assert(runInstance(graph, publish, 4, peak) == 100 + 100 && peak == 2);
+    std::cout << "Test 3 passed: Fence orders stores\n";
+
+    // Test 4: Two thread contexts share a pipeline; each computes while the
+    // other waits on memory, and every change of context costs 5 cycles
+    Pipeline pipeline(5);
+    std::vector<Core> contexts{Core(0, 1, &pipeline), Core(1, 1, &pipeline)};
+    assert(runInstances(graph, contexts, {2, 3}, peak) == 260);
+    assert(pipeline.busyCycles == 4 * 50 + 3 * 5 && pipeline.switchingCycles == 15);
+    assert(contexts[0].getBusyCycles() == 205 && contexts[1].getBusyCycles() == 260);
+    std::cout << "Test 4 passed: Contexts share a pipeline\n";
+
+    // Test 5: A core class at twice the speed halves compute, not memory
+    Pipeline fast(0, 2.0);
+    std::vector<Core> bigCore{Core(0, 1, &fast)};
+    graph.getInstances().opIndex(2) = 0;
+    assert(runInstances(graph, bigCore, {2}, peak) == 25 + 100 + 25);
+    assert(fast.busyCycles == 50);
+    std::cout << "Test 5 passed: Compute speed\n";
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "GraphAnalysis.hpp"
+#include "Simulator.hpp"
+#include <iostream>
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+
+int main() {
+    try {
+        std::cout << "Testing GraphAnalysis..." << std::endl;
+
+        // minimal_config.json: 2 cores, no cache or DTCM, so every memory op
+        // costs a local bank access of 5 + 64 / 8 + 10 = 23 cycles
+        Config config = Config::loadFromFile("minimal_config.json");
+        config.validate();
+
+        // Test 1: Instance costs, including a repeat block multiplying its body
+        {
+            std::ofstream tasks("test_analysis_chain_tasks.csv");
+            tasks << "id,name,executions,deps\n"
+                  << "1,Head,1,\n"
+                  << "2,Load,1,1\n"
+                  << "3,Loop,1,2\n"
+                  << "4,Fan,3,1\n"
+                  << "5,Sink,1,3;4\n";
+            std::ofstream ops("test_analysis_chain_ops.csv");
+            ops << "task_id,seq_idx,type,cycles,address,rw\n"
+                << "1,0,compute,100,,\n"
+                << "2,0,compute,50,,\n"
+                << "2,1,mem,0,0x1000,R\n"
+                << "3,0,repeat,4,,\n"
+                << "3,1,compute,10,,\n"
+                << "3,2,mem,0,0x2000,W\n"
+                << "3,3,end,,,\n"
+                << "4,0,compute,20,,\n"
+                << "5,0,compute,5,,\n";
+        }
+        TaskGraph chain;
+        chain.loadFromCSV("test_analysis_chain_tasks.csv", "test_analysis_chain_ops.csv");
+        GraphBounds bounds = GraphAnalysis(config).analyze(chain);
+        assert(bounds.tasks.size() == 5);
+        assert(bounds.tasks[0].cost == 100);
+        assert(bounds.tasks[1].cost == 50 + 23);
+        assert(bounds.tasks[2].cost == 4 * (10 + 23));
+        assert(bounds.tasks[2].memoryOps == 4);
+        assert(bounds.tasks[3].cost == 20);
+        assert(bounds.tasks[4].cost == 5);
+        std::cout << "Test 1 passed: Instance costs" << std::endl;
+
+        // Test 2: The chain Head -> Load -> Loop -> Sink is critical; Fan's 3
+        // instances need 2 rounds on 2 cores but stay off the critical path
+        assert(bounds.criticalPath == 100 + 73 + 132 + 5);
+        assert(bounds.totalWork == 100 + 73 + 132 + 3 * 20 + 5);
+        assert(bounds.workBound == (370 + 1) / 2);
+        assert(bounds.lowerBound == bounds.criticalPath);
+        assert(bounds.tasks[3].earliestStart == 100);
+        assert(bounds.tasks[3].upwardRank == 2 * 20 + 5);
+        assert(bounds.tasks[0].instanceRank == 100 + 73 + 132 + 5);
+        std::cout << "Test 2 passed: Chain bounds" << std::endl;
+
+        // Test 3: Zero slack along the critical chain, positive slack off it
+        assert(bounds.tasks[0].slack == 0);
+        assert(bounds.tasks[1].slack == 0);
+        assert(bounds.tasks[2].slack == 0);
+        assert(bounds.tasks[4].slack == 0);
+        assert(bounds.tasks[3].slack == 310 - (100 + 45));
+        std::cout << "Test 3 passed: Slack" << std::endl;
+
+        // Test 4: Independent leaves under one root are bound by work, not by the path
+        {
+            std::ofstream tasks("test_analysis_fan_tasks.csv");
+            tasks << "id,name,executions,deps\n"
+                  << "1,Root,1,\n"
+                  << "2,LeafA,1,1\n"
+                  << "3,LeafB,1,1\n"
+                  << "4,LeafC,1,1\n";
+            std::ofstream ops("test_analysis_fan_ops.csv");
+            ops << "task_id,seq_idx,type,cycles,address,rw\n"
+                << "1,0,compute,10,,\n"
+                << "2,0,compute,100,,\n"
+                << "3,0,compute,100,,\n"
+                << "4,0,compute,100,,\n";
+        }
+        TaskGraph fan;
+        fan.loadFromCSV("test_analysis_fan_tasks.csv", "test_analysis_fan_ops.csv");
+        GraphBounds fanBounds = GraphAnalysis(config).analyze(fan);
+        assert(fanBounds.criticalPath == 110);
+        assert(fanBounds.totalWork == 310);
+        assert(fanBounds.workBound == 155);
+        assert(fanBounds.lowerBound == 155);
+        for (const TaskBound& tb : fanBounds.tasks) {
+            assert(tb.slack == 0);
+        }
+        std::cout << "Test 4 passed: Fan-out bounds" << std::endl;
+
+        // Test 5: A load/store queue overlaps memory latency with compute
+        Config overlapped = config;
+        overlapped.lsqDepth = 4;
+        GraphAnalysis lsq(overlapped);
+        GraphBounds lsqBounds = lsq.analyze(chain);
+        assert(lsqBounds.tasks[1].cost == 50 + 23 / 4);  // Compute waits for the load
+        assert(lsqBounds.tasks[2].cost == 40);  // Stores hide behind compute
+        {
+            std::ofstream tasks("test_analysis_store_tasks.csv");
+            tasks << "id,name,executions,deps\n"
+                  << "1,Stores,1,\n";
+            std::ofstream ops("test_analysis_store_ops.csv");
+            ops << "task_id,seq_idx,type,cycles,address,rw\n"
+                << "1,0,repeat,8,,\n"
+                << "1,1,mem,0,0x3000,W\n"
+                << "1,2,end,,,\n"
+                << "1,3,compute,10,,\n";
+        }
+        TaskGraph stores;
+        stores.loadFromCSV("test_analysis_store_tasks.csv", "test_analysis_store_ops.csv");
+        assert(lsq.instanceCost(stores.getOps(1)) == 8 * 23 / 4);  // Bound by the queue
+        assert(GraphAnalysis(config).instanceCost(stores.getOps(1)) == 8 * 23 + 10);
+        std::cout << "Test 5 passed: Load/store queue overlap" << std::endl;
+
+        // Test 6: Runs are skipped only when the lower bound misses the target
+        {
+            Simulator below;
+            below.setTargetCycles(154);
+            below.initialize("minimal_config.json", "test_analysis_fan_tasks.csv", "test_analysis_fan_ops.csv");
+            assert(below.wasSkipped());
+
+            Simulator above;
+            above.setTargetCycles(155);
+            above.initialize("minimal_config.json", "test_analysis_fan_tasks.csv", "test_analysis_fan_ops.csv");
+            assert(!above.wasSkipped());
+        }
+        std::cout << "Test 6 passed: Target makespan skip" << std::endl;
+
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
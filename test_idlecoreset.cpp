@@ -0,0 +1,95 @@
+#include "IdleCoreSet.hpp"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <vector>
+
+// Linear reference search over plain flags
+static int referenceNext(const std::vector<bool>& idle, const std::vector<int>& chiplet, int only, int start) {
+    int n = static_cast<int>(idle.size());
+    for (int i = 0; i < n; i++) {
+        int core = (start + i) % n;
+        if (idle[core] && (only < 0 || chiplet[core] == only)) {
+            return core;
+        }
+    }
+    return -1;
+}
+
+int main() {
+    // Test 1: All cores start idle
+    IdleCoreSet small(5);
+    assert(small.count() == 5);
+    assert(small.next(3) == 3);
+    std::cout << "Test 1 passed: All cores idle at start\n";
+
+    // Test 2: Search wraps past the last core
+    small.erase(3);
+    small.erase(4);
+    assert(small.next(3) == 0);
+    small.erase(0);
+    small.erase(1);
+    small.erase(2);
+    assert(small.empty() && small.next(0) == -1);
+    std::cout << "Test 2 passed: Wrap-around and empty set\n";
+
+    // Test 3: Random inserts and erases match a linear scan, including
+    // per-chiplet searches with interleaved chiplets over several words
+    const int numCores = 300;
+    const int numChiplets = 3;
+    std::vector<int> chiplet(numCores);
+    for (int core = 0; core < numCores; core++) {
+        chiplet[core] = core % numChiplets;
+    }
+    IdleCoreSet set(numCores, chiplet);
+    std::vector<bool> reference(numCores, true);
+    std::mt19937 rng(7);
+    for (int step = 0; step < 20000; step++) {
+        int core = static_cast<int>(rng() % numCores);
+        if (rng() % 3 == 0) {
+            set.insert(core);
+            reference[core] = true;
+        } else {
+            set.erase(core);
+            reference[core] = false;
+        }
+        int start = static_cast<int>(rng() % numCores);
+        assert(set.next(start) == referenceNext(reference, chiplet, -1, start));
+        int only = static_cast<int>(rng() % numChiplets);
+        assert(set.nextInChiplet(only, start) == referenceNext(reference, chiplet, only, start));
+    }
+    int total = 0;
+    for (int c = 0; c < numChiplets; c++) {
+        total += set.countInChiplet(c);
+    }
+    assert(total == set.count());
+    std::cout << "Test 3 passed: Matches linear search over 20000 updates\n";
+
+    // Test 4: Rank k counts idle cores in core order, per chiplet too
+    std::vector<int> ranked;
+    for (int core = 0; core < numCores; core++) {
+        if (reference[core]) {
+            ranked.push_back(core);
+        }
+    }
+    for (int k = 0; k < set.count(); k++) {
+        assert(set.nth(k) == ranked[k]);
+    }
+    assert(set.nth(set.count()) == -1);
+    for (int c = 0; c < numChiplets; c++) {
+        std::vector<int> local;
+        for (int core : ranked) {
+            if (chiplet[core] == c) {
+                local.push_back(core);
+            }
+        }
+        for (int k = 0; k < set.countInChiplet(c); k++) {
+            assert(set.nthInChiplet(c, k) == local[k]);
+        }
+        assert(set.nthInChiplet(c, set.countInChiplet(c)) == -1);
+    }
+    std::cout << "Test 4 passed: Idle cores by rank\n";
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <fstream>
 #include <cassert>
+#include <cstring>
 
 void testCSVParser() {
     std::cout << "Testing CSV Parser..." << std::endl;
@@ -38,6 +39,119 @@ void testCSVParser() {
     }
 }
 
+void testCSVReader() {
+    std::cout << "Testing CSV Reader..." << std::endl;
+    
+    std::string text = "task_id,seq_idx,address,name\r\n"
+                       "1,0,0x80000000,\"Task, A\"\r\n"
+                       "\n"
+                       " 2 ,1,1000,B\n"
+                       "3,x,ff,C";
+    
+    try {
+        CSVReader reader(text.data(), text.size(), "inline.csv");
+        int taskCol = reader.requireColumn("task_id");
+        int seqCol = reader.requireColumn("seq_idx");
+        int addrCol = reader.requireColumn("address");
+        int nameCol = reader.requireColumn("name");
+        assert(reader.column("missing") == -1);
+        
+        assert(reader.next());
+        assert(reader.parseInt<int>(taskCol) == 1);
+        assert(reader.parseHex(addrCol) == 0x80000000);
+        assert(reader.field(nameCol) == "Task, A");
+        
+        // Blank lines are skipped and fields are trimmed
+        assert(reader.next());
+        assert(reader.parseInt<int>(taskCol) == 2);
+        assert(reader.parseHex(addrCol) == 0x1000);
+        assert(reader.lineNumber() == 4);
+        
+        // Malformed numbers are reported with their location
+        assert(reader.next());
+        bool threw = false;
+        try {
+            reader.parseInt<int>(seqCol);
+        } catch (const std::runtime_error& e) {
+            threw = std::string(e.what()).find("line 5") != std::string::npos;
+        }
+        assert(threw);
+        assert(!reader.next());
+        
+        std::cout << "  ✓ CSV Reader tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "  ✗ CSV Reader test failed: " << e.what() << std::endl;
+    }
+}
+
+void testCSVScan() {
+    std::cout << "Testing CSV Scan kernels..." << std::endl;
+    
+    // Rows straddling 16- and 32-byte blocks, quotes and a final row without newline
+    std::string text;
+    for (int i = 0; i < 40; i++) {
+        text += std::to_string(i) + "," + std::string(i % 37, 'x') + ",\"a,b\"," + std::to_string(i * 7) + "\n";
+    }
+    text += "last,row";
+    
+    SimdLevel best = CSVScan::detectLevel();
+    std::cout << "  Best level: " << CSVScan::levelName(best) << std::endl;
+    
+    // Every level must match the scalar kernel
+    CSVScan::setLevel(SimdLevel::Scalar);
+    std::vector<std::vector<uint32_t>> expected;
+    std::vector<size_t> expectedEnds;
+    std::vector<uint32_t> separators;
+    for (const char* p = text.data(); p < text.data() + text.size(); ) {
+        const char* end = CSVScan::scanRow(p, text.data() + text.size(), separators);
+        expected.push_back(separators);
+        expectedEnds.push_back(end - text.data());
+        p = end < text.data() + text.size() ? end + 1 : end;
+    }
+    assert(expected.size() == 41);
+    assert(expected.back().size() == 1);
+    
+    const char* hexCases[] = {"0", "0x0", "ff", "0xDEADbeef", "0x1000000", "ffffffffffffffff",
+                              "0x00000000000000001", "1g", "0x", "x12", "", "10000000000000000"};
+    std::vector<bool> hexOk;
+    std::vector<uint64_t> hexValues;
+    for (const char* hex : hexCases) {
+        uint64_t value = 0;
+        hexOk.push_back(CSVScan::parseHex(hex, value));
+        hexValues.push_back(value);
+    }
+    assert(hexOk[3] && hexValues[3] == 0xDEADBEEF);
+    assert(hexOk[5] && hexValues[5] == ~uint64_t(0));
+    assert(hexOk[6] && hexValues[6] == 1);
+    assert(!hexOk[7] && !hexOk[8] && !hexOk[9] && !hexOk[10] && !hexOk[11]);
+    
+    for (SimdLevel level : {SimdLevel::SSE42, SimdLevel::AVX2}) {
+        CSVScan::setLevel(level);
+        size_t row = 0;
+        for (const char* p = text.data(); p < text.data() + text.size(); row++) {
+            const char* end = CSVScan::scanRow(p, text.data() + text.size(), separators);
+            assert(separators == expected[row]);
+            assert(static_cast<size_t>(end - text.data()) == expectedEnds[row]);
+            p = end < text.data() + text.size() ? end + 1 : end;
+        }
+        for (size_t i = 0; i < hexOk.size(); i++) {
+            uint64_t value = 0;
+            bool ok = CSVScan::parseHex(hexCases[i], value);
+            assert(ok == hexOk[i]);
+            assert(!ok || value == hexValues[i]);
+        }
+        
+        // Fields ending just before a page boundary take the copying path
+        alignas(4096) static char page[8192];
+        std::memcpy(page + 4096 - 6, "0xbeef", 6);
+        uint64_t value = 0;
+        assert(CSVScan::parseHex(std::string_view(page + 4096 - 6, 6), value) && value == 0xBEEF);
+    }
+    CSVScan::setLevel(best);
+    
+    std::cout << "  ✓ CSV Scan tests passed!" << std::endl;
+}
+
 void testJSONParser() {
     std::cout << "Testing JSON Parser..." << std::endl;
     
@@ -75,8 +189,22 @@ void testJSONParser() {
         auto banks = root->get("banks");
         assert(banks->isArray());
         assert(banks->asArray().size() == 4);
-        assert(banks->asArray()[0]->asInt() == 1);
-        assert(banks->asArray()[3]->asInt() == 8);
+        assert(banks->asArray()[0].asInt() == 1);
+        assert(banks->asArray()[3].asInt() == 8);
+        
+        // Escapes are decoded in place; repeated keys keep the last value
+        auto doc = JSONParser::parseString(R"({"path": "a\\b\"c", "n": 1, "n": [{"k": null}]})");
+        assert(doc->get("path")->asString() == "a\\b\"c");
+        assert(doc->get("n")->isArray());
+        assert(doc->get("n")->asArray()[0].get("k")->isNull());
+        assert(doc->asObject()[0].key() == "path");
+        bool rejected = false;
+        try {
+            JSONParser::parseString("{} x");
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        assert(rejected);
         
         std::cout << "  ✓ JSON Parser tests passed!" << std::endl;
     } catch (const std::exception& e) {
@@ -88,6 +216,8 @@ int main() {
     std::cout << "Running Parser Tests\n" << std::endl;
     
     testCSVParser();
+    testCSVReader();
+    testCSVScan();
     testJSONParser();
     
     std::cout << "\nAll tests completed!" << std::endl;
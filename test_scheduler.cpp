@@ -0,0 +1,390 @@
+#include "SchedulingPolicies.hpp"
+#include "Simulator.hpp"
+#include <iostream>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+// Custom policy: newest ready instance first
+class LifoPolicy {
+public:
+    explicit LifoPolicy(const CorePool&) {}
+
+    void add(int instanceId, int, const CorePool&) { stack.push_back(instanceId); }
+    bool empty() const { return stack.empty(); }
+
+    int next(int, const CorePool&) {
+        int instanceId = stack.back();
+        stack.pop_back();
+        return instanceId;
+    }
+
+private:
+    std::vector<int> stack;
+};
+
+// Not a policy: no next()
+struct Incomplete {
+    void add(int, int, const CorePool&) {}
+    bool empty() const { return true; }
+};
+
+static_assert(IsSchedulingPolicy<LifoPolicy>::value, "LifoPolicy meets the requirements");
+static_assert(!IsSchedulingPolicy<Incomplete>::value, "next() is required");
+static_assert(!PolicyHasDispatch<FifoPolicy>::value && PolicyHasDispatch<AffinityPolicy>::value,
+              "dispatch() is optional");
+static_assert(Scheduler<FifoPolicy>::kDispatchOnCompletion &&
+              !Scheduler<WorkStealingPolicy>::kDispatchOnCompletion,
+              "Completion dispatch defaults to on");
+
+int main() {
+    TaskGraph graph;
+    graph.loadFromCSV("tiny_tasks.csv", "tiny_ops.csv");
+    graph.buildDAG();
+    assert(graph.getTotalInstanceCount() >= 3);
+    std::vector<std::pair<int, int>> dispatched;
+
+    // Test 1: FIFO pairs the oldest instances with idle cores in order
+    Scheduler<FifoPolicy> fifo(2, &graph, {});
+    for (int id = 0; id < 3; id++) {
+        fifo.addReady(id);
+    }
+    fifo.dispatchToIdleCores(5, dispatched);
+    assert(dispatched.size() == 2);
+    assert(dispatched[0] == std::make_pair(0, 0) && dispatched[1] == std::make_pair(1, 1));
+    assert(graph.getInstances().dispatchTime(1) == 5);
+    assert(fifo.hasReadyInstances() && fifo.idleCoreCount() == 0);
+    fifo.releaseCore(1);
+    assert(fifo.selectInstanceForCore(1) == 2 && !fifo.hasReadyInstances());
+    std::cout << "Test 1 passed: FIFO dispatch order\n";
+
+    // Test 2: A custom policy plugs in through the same template
+    Scheduler<LifoPolicy> lifo(2, &graph, {});
+    for (int id = 0; id < 3; id++) {
+        lifo.addReady(id);
+    }
+    dispatched.clear();
+    lifo.dispatchToIdleCores(0, dispatched);
+    assert(dispatched.size() == 2 && dispatched[0].first == 2 && dispatched[1].first == 1);
+    std::cout << "Test 2 passed: Custom LIFO policy\n";
+
+    // Test 3: Built-in schedulers are picked once through the variant
+    AnyScheduler any(std::in_place_type<Scheduler<CriticalPathPolicy>>, 1, &graph, std::vector<int>{},
+                     std::vector<uint64_t>{1, 3, 2, 0});
+    std::visit([](auto& sched) {
+        sched.addReady(0);
+        sched.addReady(1);
+        sched.addReady(2);
+    }, any);
+    int first = std::visit([](auto& sched) { return sched.selectInstanceForCore(0); }, any);
+    assert(first == 1);  // Highest rank first
+    std::cout << "Test 3 passed: Variant dispatch to CriticalPath\n";
+
+    // Test 4: EFT places each instance on the class finishing it first,
+    // waits for a busy class that still wins, and follows idle hints.
+    // Core 0 is big, core 1 little; costs are {big, little} per task.
+    const uint64_t kNo = EarliestFinishTimePolicy::kIneligible;
+    Scheduler<EarliestFinishTimePolicy> eft(2, &graph, {}, std::vector<int>{0, 1},
+                                            std::vector<uint64_t>{0, 0, 0, 0},
+                                            std::vector<uint64_t>{100, 300, 100, 150, 50, kNo, 400, 200},
+                                            std::vector<int>{-1, -1, -1, 0},
+                                            std::vector<std::string>{"big", "little"});
+    for (int id = 0; id < 4; id++) {
+        assert(graph.getTaskIndex(graph.getInstances().taskId(id)) == id);
+    }
+    eft.addReady(0);
+    eft.addReady(1);
+    eft.addReady(2);
+    dispatched.clear();
+    eft.dispatchToIdleCores(0, dispatched);
+    assert(dispatched.size() == 2);
+    assert(dispatched[0] == std::make_pair(0, 0) && dispatched[1] == std::make_pair(1, 1));
+    eft.releaseCore(1);
+    dispatched.clear();
+    eft.dispatchToIdleCores(150, dispatched);
+    assert(dispatched.empty());  // Instance 2 only runs on big
+    eft.releaseCore(0);
+    eft.dispatchToIdleCores(160, dispatched);
+    assert(dispatched.size() == 1 && dispatched[0] == std::make_pair(2, 0));
+    eft.releaseCore(0);
+    eft.addReady(3);
+    dispatched.clear();
+    eft.dispatchToIdleCores(300, dispatched);
+    assert(dispatched.size() == 1 && dispatched[0] == std::make_pair(3, 0));  // Hinted big
+    std::cout << "Test 4 passed: Earliest finish time placement\n";
+
+    // Policies below need more instances than the tiny graph has
+    TaskGraph wide;
+    wide.loadFromCSV("partition_tasks.csv", "partition_ops.csv");
+    wide.buildDAG();
+    assert(wide.getInstances().size() >= 64);
+    const std::vector<int> twoChiplets{0, 0, 1, 1};
+
+    // Test 5: Work stealing. The owner runs its newest instance, thieves on
+    // the other chiplet take the oldest ones and pay the remote penalty.
+    Scheduler<WorkStealingPolicy> stealing(4, &wide, twoChiplets, StealVictim::Random, 7, 20, 1u);
+    stealing.dispatch(60, 1, 0);  // Keep core 1 busy
+    stealing.addReady(10, 0);
+    stealing.addReady(11, 0);
+    stealing.addReady(12, 0);
+    dispatched.clear();
+    stealing.dispatchToIdleCores(100, dispatched);
+    assert(dispatched.size() == 3);
+    assert(dispatched[0] == std::make_pair(12, 0));
+    assert(wide.getInstances().dispatchTime(12) == 100);
+    assert(dispatched[1].first == 10 && dispatched[2].first == 11);
+    for (int i = 1; i < 3; i++) {
+        assert(stealing.chipletOf(dispatched[i].second) == 1);
+        assert(wide.getInstances().dispatchTime(dispatched[i].first) == 100 + 7 + 20);
+    }
+    assert(!stealing.hasReadyInstances());
+
+    // The chiplet victim mode steals within the thief's chiplet whatever the
+    // seed; the random mode lands on the other chiplet for some seed
+    auto stealFor = [&](StealVictim victim, uint32_t seed) {
+        Scheduler<WorkStealingPolicy> sched(4, &wide, twoChiplets, victim, 7, 20, seed);
+        sched.dispatch(60, 0, 0);
+        sched.dispatch(61, 2, 0);
+        sched.dispatch(62, 3, 0);
+        sched.addReady(10, 0);
+        sched.addReady(20, 2);
+        dispatched.clear();
+        sched.dispatchToIdleCores(100, dispatched);
+        assert(dispatched.size() == 1 && dispatched[0].second == 1);
+        return dispatched[0].first;
+    };
+    bool crossedChiplets = false;
+    for (uint32_t seed = 0; seed < 16; seed++) {
+        assert(stealFor(StealVictim::Chiplet, seed) == 10);
+        assert(wide.getInstances().dispatchTime(10) == 100 + 7);
+        int random = stealFor(StealVictim::Random, seed);
+        assert(random == stealFor(StealVictim::Random, seed));  // Same seed, same victim
+        crossedChiplets |= random == 20;
+    }
+    assert(crossedChiplets);
+
+    // Random victims are uniform over the cores with queued work. With work
+    // on cores 0 and 1 of four, a random start scanned forward would pick
+    // core 0 for three starts out of four.
+    int fromFirst = 0;
+    for (uint32_t seed = 0; seed < 200; seed++) {
+        Scheduler<WorkStealingPolicy> sched(4, &wide, twoChiplets, StealVictim::Random, 7, 20, seed);
+        sched.dispatch(60, 0, 0);
+        sched.dispatch(61, 1, 0);
+        sched.dispatch(62, 2, 0);
+        sched.addReady(10, 0);
+        sched.addReady(20, 1);
+        dispatched.clear();
+        sched.dispatchToIdleCores(100, dispatched);
+        assert(dispatched.size() == 1 && dispatched[0].second == 3);
+        fromFirst += dispatched[0].first == 10;
+    }
+    assert(fromFirst > 70 && fromFirst < 130);
+    std::cout << "Test 5 passed: Work stealing order, latency and victims\n";
+
+    // Test 6: Hierarchical. Chiplet schedulers make one decision per
+    // dispatch_interval and start instances dispatch_latency later; the
+    // balancer feeds idle chiplets from the longest queue at migration_cycles each.
+    Scheduler<HierarchicalPolicy> hierarchical(6, &wide, {0, 0, 1, 1, 2, 2}, 5, 3, 50);
+    hierarchical.addReady(10, 0);
+    hierarchical.addReady(11, 1);
+    dispatched.clear();
+    hierarchical.dispatchToIdleCores(100, dispatched);
+    assert(dispatched.size() == 2 && hierarchical.chipletOf(dispatched[1].second) == 0);
+    assert(wide.getInstances().dispatchTime(10) == 105);
+    assert(wide.getInstances().dispatchTime(11) == 108);
+
+    hierarchical.dispatch(60, 2, 100);  // Chiplets 0 and 1 busy, chiplet 2 idle
+    hierarchical.dispatch(61, 3, 100);
+    hierarchical.addReady(12, 0);
+    hierarchical.addReady(20, 2);
+    hierarchical.addReady(21, 3);
+    hierarchical.addReady(22, 2);
+    dispatched.clear();
+    hierarchical.dispatchToIdleCores(200, dispatched);
+    assert(dispatched.size() == 2);
+    assert(dispatched[0] == std::make_pair(20, 4) && dispatched[1] == std::make_pair(21, 5));
+    assert(wide.getInstances().dispatchTime(20) == 200 + 50 + 5);
+    assert(wide.getInstances().dispatchTime(21) == 200 + 2 * 50 + 5);
+    assert(hierarchical.hasReadyInstances());  // 12 and 22 wait for their chiplets
+
+    const HierarchicalPolicy& loads = hierarchical.getPolicy();
+    assert(loads.getChipletLoads()[0].dispatches == 2 && loads.getChipletLoads()[0].queueingDelay == 3);
+    assert(loads.getChipletLoads()[1].dispatches == 0);
+    assert(loads.getChipletLoads()[2].dispatches == 2 && loads.getChipletLoads()[2].queueingDelay == 0);
+    assert(loads.getBalancerLoad().dispatches == 2);
+    assert(loads.getBalancerLoad().busyCycles == 100 && loads.getBalancerLoad().queueingDelay == 50);
+    std::cout << "Test 6 passed: Hierarchical dispatch cost and balancing\n";
+
+    // Test 7: Lazy materialization with a window covering the frontier must
+    // not change the schedule of policies that queue work near its producer
+    auto makespan = [](const std::string& policy, const std::string& materialization) {
+        std::string path = "test_" + policy + "_" + materialization + ".json";
+        std::ofstream(path) << "{\"cores\": 4, \"chiplets\": 2, \"scheduling_policy\": \"" << policy
+                            << "\", \"chiplet\": {\"remote_penalty_cycles\": 20},"
+                            << " \"task_instances\": {\"materialization\": \"" << materialization
+                            << "\", \"ready_window\": 1000000}}";
+        Simulator sim;
+        sim.setStatsPath((std::filesystem::temp_directory_path() / "test_scheduler_stats.json").string());
+        sim.initialize(path, "chain_fanout_tasks.csv", "chain_fanout_ops.csv");
+        sim.run();
+        return sim.getCurrentTime();
+    };
+    for (const char* policy : {"work_stealing", "hierarchical"}) {
+        uint64_t eager = makespan(policy, "eager");
+        uint64_t lazy = makespan(policy, "lazy");
+        std::cout << policy << ": " << eager << " cycles eager, " << lazy << " lazy\n";
+        assert(eager == lazy);
+    }
+    std::cout << "Test 7 passed: Lazy and eager schedules match\n";
+
+    // Test 8: Bandwidth-aware admission. Two bank requests are in flight
+    // against a limit of two (two banks, one port each, threshold 1.0).
+    Config memoryConfig = Config::loadFromFile("minimal_config.json");
+    memoryConfig.validate();
+    MemorySystem memory(memoryConfig);
+    memory.setEventScheduler([](Event, void*) {}, nullptr);
+    memory.setOccupancyTracking(true);
+    memory.issueRequest(0x0, AccessType::Read, 0, 0, 0);
+    memory.issueRequest(0x40, AccessType::Read, 1, 0, 0);
+    assert(memory.getBankRequestsInFlight(0) == 2);
+
+    // Partition instances (task index 1) are memory-bound, Scatter and Gather not
+    std::vector<char> memoryBound{0, 1, 0};
+    const int scatter = 0;
+    const int gather = static_cast<int>(wide.getInstances().size()) - 1;
+    assert(wide.getTaskIndex(wide.getInstances().taskId(scatter)) == 0);
+    assert(wide.getTaskIndex(wide.getInstances().taskId(1)) == 1);
+    assert(wide.getTaskIndex(wide.getInstances().taskId(gather)) == 2);
+
+    std::vector<uint64_t> memoryOps{0, 4, 0};
+    Scheduler<BandwidthAwarePolicy> bandwidth(4, &wide, {}, memoryBound, memoryOps, 1, &memory, 1.0);
+    bandwidth.addReady(1);        // Oldest, memory-bound
+    bandwidth.addReady(scatter);  // Compute-bound
+    bandwidth.addReady(2);
+    bandwidth.addReady(3);
+    dispatched.clear();
+    bandwidth.dispatchToIdleCores(0, dispatched);
+
+    // At the limit the compute-bound instance goes first; memory-bound ones
+    // then start as the requests in flight are answered, the one beyond
+    // them waits for a completion to dispatch it
+    assert(dispatched.size() == 3);
+    assert(dispatched[0].first == scatter && wide.getInstances().dispatchTime(scatter) == 0);
+    assert(dispatched[1].first == 1 && dispatched[2].first == 2);
+    assert(wide.getInstances().dispatchTime(1) == memory.getBankRequestDoneTime(1));
+    assert(wide.getInstances().dispatchTime(2) == memory.getBankRequestDoneTime(2));
+    assert(memory.getBankRequestDoneTime(1) > 0);
+    assert(bandwidth.hasReadyInstances() && bandwidth.idleCoreCount() == 1);
+
+    // Without a memory system there is nothing to admit against
+    try {
+        Scheduler<BandwidthAwarePolicy> unbound(1, &wide, {}, memoryBound, memoryOps, 1, nullptr, 1.0);
+        std::cerr << "ERROR: BandwidthAwarePolicy accepted a null MemorySystem" << std::endl;
+        return 1;
+    } catch (const std::invalid_argument&) {
+    }
+
+    // With a deeper load/store queue an admitted instance counts as all the
+    // requests it can keep in flight: min(depth, memory ops) = 4 fills the
+    // limit of two on its own, so the next memory-bound instance waits
+    MemorySystem idleMemory(memoryConfig);
+    idleMemory.setOccupancyTracking(true);
+    Scheduler<BandwidthAwarePolicy> deep(4, &wide, {}, memoryBound, memoryOps, 8, &idleMemory, 1.0);
+    deep.addReady(1);
+    deep.addReady(2);
+    deep.addReady(scatter);
+    dispatched.clear();
+    deep.dispatchToIdleCores(0, dispatched);
+    assert(dispatched.size() == 2 && dispatched[0].first == 1 && dispatched[1].first == scatter);
+    assert(deep.hasReadyInstances());
+    std::cout << "Test 8 passed: Bandwidth-aware admission\n";
+
+    // Test 9: ShortestOpsFirst dequeues the fewest remaining ops first and
+    // breaks ties in ready order. Op counts per task: 3, 1, 3, 2, 1.
+    {
+        std::ofstream tasks("test_shortest_tasks.csv");
+        tasks << "id,name,executions,deps\n"
+              << "1,Three,1,\n"
+              << "2,One,1,\n"
+              << "3,AlsoThree,1,\n"
+              << "4,Two,1,\n"
+              << "5,AlsoOne,1,\n";
+        std::ofstream ops("test_shortest_ops.csv");
+        ops << "task_id,seq_idx,type,cycles,address,rw\n";
+        const int opCounts[] = {3, 1, 3, 2, 1};
+        for (int t = 0; t < 5; t++) {
+            for (int k = 0; k < opCounts[t]; k++) {
+                ops << t + 1 << "," << k << ",compute,10,,\n";
+            }
+        }
+    }
+    TaskGraph mixed;
+    mixed.loadFromCSV("test_shortest_tasks.csv", "test_shortest_ops.csv");
+    mixed.buildDAG();
+    Scheduler<ShortestOpsFirstPolicy> shortest(1, &mixed, {});
+    for (int id = 0; id < 5; id++) {
+        assert(mixed.getInstances().taskId(id) == id + 1);
+        shortest.addReady(id);
+    }
+    for (int expected : {1, 4, 3, 0, 2}) {
+        assert(shortest.selectInstanceForCore(0) == expected);
+    }
+    assert(!shortest.hasReadyInstances());
+    std::cout << "Test 9 passed: ShortestOpsFirst order\n";
+
+    // Test 10: CriticalPath ranks a four-task chain above a fan-out of four
+    // leaves under a short root, so the chain runs first even when the
+    // leaves were ready before it. Every op is 10 compute cycles, Root 5.
+    {
+        std::ofstream tasks("test_critical_tasks.csv");
+        tasks << "id,name,executions,deps\n"
+              << "1,Chain0,1,\n"
+              << "2,Chain1,1,1\n"
+              << "3,Chain2,1,2\n"
+              << "4,Chain3,1,3\n"
+              << "5,Root,1,\n"
+              << "6,Leaf,4,5\n";
+        std::ofstream ops("test_critical_ops.csv");
+        ops << "task_id,seq_idx,type,cycles,address,rw\n";
+        for (int t = 1; t <= 6; t++) {
+            ops << t << ",0,compute," << (t == 5 ? 5 : 10) << ",,\n";
+        }
+    }
+    TaskGraph split;
+    split.loadFromCSV("test_critical_tasks.csv", "test_critical_ops.csv");
+    split.buildDAG();
+    Config plainConfig;
+    GraphBounds splitBounds = GraphAnalysis(plainConfig).analyze(split);
+    std::vector<uint64_t> ranks;
+    for (const TaskBound& tb : splitBounds.tasks) {
+        ranks.push_back(tb.instanceRank);
+    }
+    assert((ranks == std::vector<uint64_t>{40, 30, 20, 10, 15, 10}));
+
+    // Instances: 0..3 the chain, 4 Root, 5..8 the leaves
+    assert(split.getInstances().taskId(4) == 5 && split.getInstances().taskId(5) == 6);
+    Scheduler<CriticalPathPolicy> critical(1, &split, {}, ranks);
+    for (int leaf = 5; leaf < 9; leaf++) {
+        critical.addReady(leaf);
+    }
+    critical.addReady(0);
+    dispatched.clear();
+    critical.dispatchToIdleCores(0, dispatched);
+    assert(dispatched.size() == 1 && dispatched[0].first == 0);
+    assert(critical.selectInstanceForCore(0) == 5);
+    critical.addReady(1);  // Ready after the leaves, still ahead of them
+    assert(critical.selectInstanceForCore(0) == 1);
+    for (int leaf = 6; leaf < 9; leaf++) {
+        assert(critical.selectInstanceForCore(0) == leaf);  // Equal ranks in ready order
+    }
+    assert(!critical.hasReadyInstances());
+    std::cout << "Test 10 passed: CriticalPath ranks and order\n";
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
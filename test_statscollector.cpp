@@ -39,6 +39,13 @@ int main() {
     // Test 7: Set total cycles
     stats.setTotalCycles(1000);
     std::cout << "✓ Total cycles set\n";
+
+    // Test 7b: Deadline misses (latency past the task's deadline)
+    stats.recordDeadline(1, 200, 150);
+    stats.recordDeadline(1, 200, 200);
+    stats.recordDeadline(1, 200, 260);
+    assert(stats.getDeadlineMisses() == 1);
+    std::cout << "✓ Deadline misses counted\n";
     
     // Test 8: Generate report
     std::cout << "\n--- Testing Console Report ---\n";